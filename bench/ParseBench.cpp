@@ -0,0 +1,71 @@
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <string>
+
+#include "kyoto/ParsedModule.h"
+
+// Parses a generated, expression-heavy source with either prediction strategy. Run each strategy in its own process
+// so that the first (cold) parse does not inherit the DFA cache built by the other one:
+//
+//     parse_bench two-stage 50000
+//     parse_bench ll 50000
+
+namespace {
+
+std::string generate_source(size_t target_lines)
+{
+    std::string source;
+    size_t lines = 0;
+    for (size_t n = 0; lines < target_lines; ++n) {
+        source += std::format("fn f{}(a: i32, b: i32) i32 {{\n"
+                              "    var x: i32 = a * 2 + b - (a / 3) % 7;\n"
+                              "    var y: i32 = x;\n"
+                              "    for (var i: i32 = 0; i < b; ++i) {{\n"
+                              "        y = y + i * x - (i + 1) / 2;\n"
+                              "    }}\n"
+                              "    if (x < y && y >= 0 || !(x == y)) {{\n"
+                              "        return f{}(x, y) + y;\n"
+                              "    }}\n"
+                              "    return match x {{ 1 => 2, default => y, }};\n"
+                              "}}\n\n",
+                              n, n == 0 ? 0 : n - 1);
+        lines += 12;
+    }
+    return source;
+}
+
+double parse_ms(const std::string& source, ParsedModule::Prediction prediction)
+{
+    const auto start = std::chrono::steady_clock::now();
+    auto parsed = ParsedModule::parse(source, prediction);
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+}
+
+int main(int argc, const char* argv[])
+{
+    const std::string mode = argc > 1 ? argv[1] : "two-stage";
+    const size_t lines = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 50000;
+    if (mode != "two-stage" && mode != "ll") {
+        std::cerr << "Usage: " << argv[0] << " [two-stage|ll] [lines]" << std::endl;
+        return 1;
+    }
+
+    const auto prediction = mode == "ll" ? ParsedModule::Prediction::FullLL : ParsedModule::Prediction::TwoStage;
+    const auto source = generate_source(lines);
+
+    constexpr int warm_runs = 5;
+    const auto cold = parse_ms(source, prediction);
+    double warm = 0;
+    for (int i = 0; i < warm_runs; ++i) {
+        warm += parse_ms(source, prediction);
+    }
+
+    std::cout << std::format("{}: {} lines, cold {:.1f} ms, warm {:.1f} ms (mean of {})\n", mode, lines, cold,
+                             warm / warm_runs, warm_runs);
+    return 0;
+}
@@ -0,0 +1,143 @@
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "kyoto/AST/ASTNode.h"
+#include "kyoto/AST/Expressions/BinaryNode.h"
+#include "kyoto/AST/Expressions/FunctionCallNode.h"
+#include "kyoto/AST/Expressions/IdentifierNode.h"
+#include "kyoto/AST/Expressions/NumberNode.h"
+#include "kyoto/ModuleCompiler.h"
+#include "kyoto/Resolution/AnalysisVisitor.h"
+
+// Walks a generated AST with the same three visitor shapes the compiler registers: once per visitor through
+// AnalysisVisitor (kind tags), once with all three fused into a single FusedAnalysisVisitor walk, and once through an
+// equivalent dynamic_cast walk, which is how AnalysisVisitor used to dispatch:
+//
+//     visitor_bench 20000
+
+namespace {
+
+template <typename NodeToVisit>
+class CountingVisitor : public AnalysisVisitor<CountingVisitor<NodeToVisit>, NodeToVisit> {
+public:
+    static constexpr bool descends_into_matches = true;
+
+    using AnalysisVisitor<CountingVisitor<NodeToVisit>, NodeToVisit>::visit;
+    void visit(NodeToVisit*) override { ++count; }
+
+    size_t count = 0;
+};
+
+template <typename NodeToVisit> void dynamic_cast_walk(ASTNode* node, size_t& count)
+{
+    if (!node) return;
+    for (auto* child : node->get_children()) {
+        if (dynamic_cast<NodeToVisit*>(child)) ++count;
+        dynamic_cast_walk<NodeToVisit>(child, count);
+    }
+}
+
+ExpressionNode* generate_expression(size_t depth, size_t n, ModuleCompiler& compiler)
+{
+    auto& types = compiler.get_type_context();
+    if (depth == 0) {
+        if (n % 3 == 0) return new IdentifierExpressionNode(std::format("v{}", n), compiler);
+        return new NumberNode(static_cast<int64_t>(n), types.primitive(PrimitiveType::Kind::I32), compiler);
+    }
+
+    auto* lhs = generate_expression(depth - 1, n * 2, compiler);
+    auto* rhs = generate_expression(depth - 1, n * 2 + 1, compiler);
+    switch (depth % 4) {
+    case 0:
+        return new AddNode(lhs, rhs, compiler);
+    case 1:
+        return new MulNode(lhs, rhs, compiler);
+    case 2:
+        return new LessNode(lhs, rhs, compiler);
+    default:
+        return new FunctionCall(std::format("f{}", n), { lhs, rhs }, compiler);
+    }
+}
+
+std::unique_ptr<ASTNode> generate_program(size_t functions, ModuleCompiler& compiler)
+{
+    std::vector<ASTNode*> nodes;
+    nodes.reserve(functions);
+    for (size_t i = 0; i < functions; ++i) {
+        std::vector<ASTNode*> statements;
+        for (size_t j = 0; j < 4; ++j) {
+            statements.push_back(new ExpressionStatementNode(generate_expression(5, i + j, compiler), compiler));
+        }
+        auto* body = new BlockNode(std::move(statements), compiler);
+        nodes.push_back(new FunctionNode(std::format("f{}", i), {}, false,
+                                         compiler.get_type_context().primitive(PrimitiveType::Kind::I32), body,
+                                         compiler));
+    }
+    return std::make_unique<ProgramNode>(std::move(nodes), compiler);
+}
+
+template <typename Fn> double time_ms(Fn&& fn)
+{
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+}
+
+int main(int argc, const char* argv[])
+{
+    const size_t functions = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+
+    ModuleCompiler compiler("", "visitor_bench");
+    const auto program = generate_program(functions, compiler);
+
+    constexpr int runs = 10;
+    size_t tagged_count = 0;
+    size_t fused_count = 0;
+    size_t dynamic_count = 0;
+    double tagged = 0;
+    double fused = 0;
+    double dynamic = 0;
+    for (int i = 0; i < runs; ++i) {
+        tagged += time_ms([&] {
+            CountingVisitor<FunctionNode> functions_visitor;
+            CountingVisitor<FunctionCall> calls_visitor;
+            CountingVisitor<NumberNode> numbers_visitor;
+            functions_visitor.visit(program.get());
+            calls_visitor.visit(program.get());
+            numbers_visitor.visit(program.get());
+            tagged_count = functions_visitor.count + calls_visitor.count + numbers_visitor.count;
+        });
+        fused += time_ms([&] {
+            FusedAnalysisVisitor<CountingVisitor<FunctionNode>, CountingVisitor<FunctionCall>,
+                                 CountingVisitor<NumberNode>>
+                visitor({}, {}, {});
+            visitor.visit(program.get());
+            fused_count = visitor.get<0>().count + visitor.get<1>().count + visitor.get<2>().count;
+        });
+        dynamic += time_ms([&] {
+            dynamic_count = 0;
+            dynamic_cast_walk<FunctionNode>(program.get(), dynamic_count);
+            dynamic_cast_walk<FunctionCall>(program.get(), dynamic_count);
+            dynamic_cast_walk<NumberNode>(program.get(), dynamic_count);
+        });
+    }
+
+    if (tagged_count != dynamic_count || fused_count != dynamic_count) {
+        std::cerr << std::format("Visited {} nodes with kind tags, {} in one fused walk but {} with dynamic_cast\n",
+                                 tagged_count, fused_count, dynamic_count);
+        return 1;
+    }
+
+    std::cout << std::format(
+        "{} functions, {} matches: kind tags {:.2f} ms, fused {:.2f} ms, dynamic_cast {:.2f} ms (mean of {})\n",
+        functions, tagged_count, tagged / runs, fused / runs, dynamic / runs, runs);
+    return 0;
+}
@@ -50,4 +50,4 @@ endif()
 include_directories(SYSTEM ${LLVM_INCLUDE_DIRS})
 separate_arguments(LLVM_DEFINITIONS_LIST NATIVE_COMMAND ${LLVM_DEFINITIONS})
 add_definitions(${LLVM_DEFINITIONS_LIST})
-llvm_map_components_to_libnames(llvm_libs support core irreader passes linker)
+llvm_map_components_to_libnames(llvm_libs support core irreader passes linker bitreader bitwriter transformutils orcjit native)
@@ -85,12 +85,20 @@ CONSTRUCTOR: 'constructor';
 
 NEW: 'new';
 FREE: 'free';
+WITH: 'with';
+ARENA: 'arena';
+ALIGN: 'align';
+ZEROED: 'zeroed';
 
 SIZEOF: 'sizeof';
 
 TYPEALIAS: 'typealias';
 IMPORT: 'import';
 
+// Vector types such as `i32x8`. Only the supported lane counts are reserved; other names of this shape, such as
+// `i32x3`, lex as identifiers and are rejected where they are used as a type.
+VECTOR_TYPE: ('bool' | 'i8' | 'i16' | 'i32' | 'i64' | 'f32' | 'f64') 'x' ('2' | '4' | '8' | '16' | '32' | '64');
+
 // This has to be defined after all the keywords because it will match all of them if defined first.
 // IDENTIFIER: LETTER (LETTER | [0-9])*;
 // fragment LETTER: [a-zA-Z\u0080-\u{10FFFF}_];
@@ -39,6 +39,7 @@ statement:
 	| whileStatement
 	| returnStatement
 	| freeStatement
+	| arenaStatement
 	| typeAliasStatement;
 
 expressionStatement: expression SEMICOLON;
@@ -51,7 +52,7 @@ expression:
 	| anonymousFunction													# anonymousFunctionExpression
 	| LPAREN expression RPAREN											# parenthesizedExpression
 	| NEW type LPAREN expressionList RPAREN								# newExpression
-	| NEW type OPEN_BRACKET expression CLOSE_BRACKET					# newArrayExpression
+	| NEW (ALIGN LPAREN INTEGER RPAREN)? ZEROED? type OPEN_BRACKET expression CLOSE_BRACKET	# newArrayExpression
 	| SIZEOF LPAREN (expression | type) RPAREN							# sizeofExpression
 	| MATCH expression OPEN_BRACE matchCase+ CLOSE_BRACE				# matchExpression
 	| OPEN_BRACKET expression COMMA expression CLOSE_BRACKET			# sliceExpression
@@ -101,6 +102,8 @@ returnStatement: RETURN expression? SEMICOLON;
 
 freeStatement: FREE expression SEMICOLON;
 
+arenaStatement: WITH ARENA block;
+
 typeAliasStatement: TYPEALIAS type IDENTIFIER SEMICOLON;
 
 ifStatement: IF LPAREN expression RPAREN block elseIfElseStatement;
@@ -146,6 +149,7 @@ type:
 	| F32																# f32Type
 	| F64																# f64Type
 	| STRING															# strType
+	| VECTOR_TYPE														# vectorType
 	| VOID																# voidType
 	| FN LPAREN functionTypeParameterList RPAREN type					# functionType
 	| modulePath DOUBLE_COLON IDENTIFIER (LESS_THAN type GREATER_THAN)?	# qualifiedClassType
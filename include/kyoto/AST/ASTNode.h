@@ -2,7 +2,9 @@
 
 #include <format>
 #include <iostream>
+#include <new>
 
+#include "llvm/ADT/STLFunctionExtras.h"
 #include "llvm/IR/Type.h"
 
 #include "kyoto/KType.h"
@@ -18,16 +20,97 @@ class Function;
 
 class ASTNode {
 public:
+    // One tag per concrete node class, LLVM-RTTI style. Subclasses of a common base are kept contiguous so that the
+    // base's classof is a range check.
+    enum class Kind {
+        ProgramNode,
+        ExpressionStatementNode,
+        BlockNode,
+        FunctionNode,
+        ConstructorNode,
+        ReturnStatementNode,
+        IfStatementNode,
+        ForStatementNode,
+        ClassDefinitionNode,
+        TypeAliasNode,
+        FreeStatementNode,
+        ArenaStatementNode,
+        DeclarationStatementNode,
+        FullDeclarationStatementNode,
+
+        AnonymousFunctionNode,
+        ArrayIndexNode,
+        ArrayNode,
+        AssignmentNode,
+        AddNode,
+        SubNode,
+        MulNode,
+        DivNode,
+        ModNode,
+        EqNode,
+        NotEqNode,
+        LessNode,
+        GreaterNode,
+        LessEqNode,
+        GreaterEqNode,
+        LogicalAndNode,
+        LogicalOrNode,
+        CastNode,
+        FunctionCall,
+        MethodCall,
+        IdentifierExpressionNode,
+        MatchNode,
+        MemberAccessNode,
+        NewArrayNode,
+        NewNode,
+        NumberNode,
+        SizeofNode,
+        SliceNode,
+        StringLiteralNode,
+        UnaryNode,
+        VectorReduceNode,
+
+        FirstFunction = FunctionNode,
+        LastFunction = ConstructorNode,
+        FirstExpression = AnonymousFunctionNode,
+        LastExpression = VectorReduceNode,
+        FirstFunctionCall = FunctionCall,
+        LastFunctionCall = MethodCall,
+    };
+
     virtual ~ASTNode() = default;
+
+    // Nodes built by ASTBuilderVisitor live in their module's ASTArena, so a `delete` from a parent leaves them alive.
+    void operator delete(ASTNode* node, std::destroying_delete_t);
+
+    using ChildCallback = llvm::function_ref<void(ASTNode*)>;
+
     [[nodiscard]] virtual std::string to_string() const = 0;
     virtual llvm::Value* gen() = 0;
-    virtual std::vector<ASTNode*> get_children() const = 0;
+    // Calls `fn` on each present direct child, in source order, without building a container.
+    virtual void for_each_child(ChildCallback fn) const = 0;
+    [[nodiscard]] std::vector<ASTNode*> get_children() const;
 
-    template <typename T> bool is() const { return dynamic_cast<const T*>(this) != nullptr; }
-    template <typename T> T* as() { return dynamic_cast<T*>(this); }
-    template <typename T> const T* as() const { return dynamic_cast<const T*>(this); }
+    [[nodiscard]] Kind get_kind() const { return kind; }
+
+    template <typename T> bool is() const { return T::classof(this); }
+    template <typename T> T* as() { return is<T>() ? static_cast<T*>(this) : nullptr; }
+    template <typename T> const T* as() const { return is<T>() ? static_cast<const T*>(this) : nullptr; }
+
+    static bool classof(const ASTNode*) { return true; }
 
     static llvm::Type* get_llvm_type(const KType* type, ModuleCompiler& compiler);
+
+protected:
+    explicit ASTNode(Kind kind)
+        : kind(kind)
+    {
+    }
+
+private:
+    friend class ASTArena;
+    const Kind kind;
+    bool arena_allocated = false;
 };
 
 class ProgramNode final : public ASTNode {
@@ -38,7 +121,12 @@ public:
     [[nodiscard]] std::string to_string() const override;
     [[nodiscard]] llvm::Value* gen() override;
 
-    [[nodiscard]] std::vector<ASTNode*> get_children() const override { return nodes; }
+    void for_each_child(ChildCallback fn) const override
+    {
+        for (auto* node : nodes) fn(node);
+    }
+
+    static bool classof(const ASTNode* node) { return node->get_kind() == Kind::ProgramNode; }
 
 private:
     std::vector<ASTNode*> nodes;
@@ -55,7 +143,9 @@ public:
 
     [[nodiscard]] ExpressionNode* get_expr() const { return expr; }
 
-    [[nodiscard]] std::vector<ASTNode*> get_children() const override;
+    void for_each_child(ChildCallback fn) const override;
+
+    static bool classof(const ASTNode* node) { return node->get_kind() == Kind::ExpressionStatementNode; }
 
 private:
     ExpressionNode* expr;
@@ -69,7 +159,12 @@ public:
     [[nodiscard]] std::string to_string() const override;
     [[nodiscard]] llvm::Value* gen() override;
 
-    [[nodiscard]] std::vector<ASTNode*> get_children() const override { return nodes; }
+    void for_each_child(ChildCallback fn) const override
+    {
+        for (auto* node : nodes) fn(node);
+    }
+
+    static bool classof(const ASTNode* node) { return node->get_kind() == Kind::BlockNode; }
 
 private:
     std::vector<ASTNode*> nodes;
@@ -94,7 +189,10 @@ public:
     [[nodiscard]] const std::vector<Parameter>& get_params() const { return args; }
     [[nodiscard]] std::string get_name() const { return name; }
     [[nodiscard]] const std::string& get_linkage_name() const { return linkage_name; }
-    [[nodiscard]] std::vector<ASTNode*> get_children() const override { return { body }; }
+    void for_each_child(ChildCallback fn) const override
+    {
+        if (body) fn(body);
+    }
 
     [[nodiscard]] KType* get_ret_type() const { return ret_type; }
     [[nodiscard]] bool is_varargs() const { return varargs; }
@@ -105,6 +203,20 @@ public:
 
     [[nodiscard]] bool is_external() const { return is_external_function; }
 
+    // Methods of template instances are emitted by whichever module instantiates them first, so they are given
+    // linkonce_odr linkage and every cached module unit that uses them carries its own copy.
+    void mark_template_instance() { template_instance = true; }
+    [[nodiscard]] bool is_template_instance() const { return template_instance; }
+
+    static bool classof(const ASTNode* node)
+    {
+        return node->get_kind() >= Kind::FirstFunction && node->get_kind() <= Kind::LastFunction;
+    }
+
+protected:
+    FunctionNode(Kind kind, std::string name, std::vector<Parameter> args, bool varargs, KType* ret_type, ASTNode* body,
+                 ModuleCompiler& compiler, bool is_external = false, std::string linkage_name = "");
+
 private:
     [[nodiscard]] std::vector<llvm::Type*> get_arg_types() const;
 
@@ -116,4 +228,5 @@ private:
     ModuleCompiler& compiler;
     bool is_external_function;
     std::string linkage_name;
+    bool template_instance = false;
 };
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string>
+
+#include "kyoto/AST/ASTNode.h"
+
+class ModuleCompiler;
+
+// `with arena { ... }`: every `new` written inside the block is bump-allocated from an arena that is released as a
+// whole when the block is left, whether by falling off its end or by returning.
+class ArenaStatementNode : public ASTNode {
+    ASTNode* body;
+    ModuleCompiler& compiler;
+
+public:
+    ArenaStatementNode(ASTNode* body, ModuleCompiler& compiler);
+    ~ArenaStatementNode() override;
+
+    [[nodiscard]] std::string to_string() const override;
+    [[nodiscard]] llvm::Value* gen() override;
+    void for_each_child(ChildCallback fn) const override;
+
+    static bool classof(const ASTNode* node) { return node->get_kind() == Kind::ArenaStatementNode; }
+};
@@ -14,11 +14,16 @@ public:
     ~ClassDefinitionNode();
     [[nodiscard]] std::string to_string() const override;
     [[nodiscard]] llvm::Value* gen() override;
-    [[nodiscard]] const ASTNode* get_declaration_of(const std::string& name) const;
 
     [[nodiscard]] std::string get_name() const { return name; }
     [[nodiscard]] std::string get_parent() const { return parent; }
-    [[nodiscard]] std::vector<ASTNode*> get_children() const override { return components; }
+    [[nodiscard]] const std::vector<ASTNode*>& get_components() const { return components; }
+    void for_each_child(ChildCallback fn) const override
+    {
+        for (auto* component : components) fn(component);
+    }
+
+    static bool classof(const ASTNode* node) { return node->get_kind() == Kind::ClassDefinitionNode; }
 
 private:
     std::string name;
@@ -34,4 +39,6 @@ public:
     ~ConstructorNode() override;
 
     [[nodiscard]] llvm::Value* gen() override;
+
+    static bool classof(const ASTNode* node) { return node->get_kind() == Kind::ConstructorNode; }
 };
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <vector>
 
 #include "kyoto/AST/ASTNode.h"
+#include "kyoto/SymbolTable.h"
 
 class ModuleCompiler;
 class KType;
@@ -24,12 +25,16 @@ public:
 
     [[nodiscard]] KType* get_ktype() const { return type; }
     [[nodiscard]] std::string get_name() const { return name; }
-    [[nodiscard]] std::vector<ASTNode*> get_children() const override { return {}; }
+    [[nodiscard]] SymbolTable::SymbolId get_symbol_id() const { return symbol_id; }
+    void for_each_child(ChildCallback) const override { }
+
+    static bool classof(const ASTNode* node) { return node->get_kind() == Kind::DeclarationStatementNode; }
 
 private:
     std::string name;
     KType* type;
     ModuleCompiler& compiler;
+    SymbolTable::SymbolId symbol_id;
 };
 
 class FullDeclarationStatementNode final : public ASTNode {
@@ -41,8 +46,11 @@ public:
     [[nodiscard]] llvm::Value* gen() override;
     [[nodiscard]] KType* get_ktype() const { return type; }
     [[nodiscard]] std::string get_name() const { return name; }
+    [[nodiscard]] SymbolTable::SymbolId get_symbol_id() const { return symbol_id; }
     [[nodiscard]] ExpressionNode* get_expression() const { return expr; }
-    [[nodiscard]] std::vector<ASTNode*> get_children() const override;
+    void for_each_child(ChildCallback fn) const override;
+
+    static bool classof(const ASTNode* node) { return node->get_kind() == Kind::FullDeclarationStatementNode; }
 
 private:
     void initialize_type();
@@ -51,6 +59,7 @@ private:
     llvm::AllocaInst* create_alloca() const;
     llvm::Value* generate_expression_value(llvm::AllocaInst* alloca);
     bool is_assigning_to_class_instance() const;
+    bool is_initializing_array_literal() const;
     llvm::Value* handle_constructor_call(llvm::AllocaInst* alloca) const;
     void store_val_and_register_symbol(llvm::Value* expr_val, llvm::AllocaInst* alloca) const;
 
@@ -59,4 +68,5 @@ private:
     KType* type;
     ExpressionNode* expr;
     ModuleCompiler& compiler;
+    SymbolTable::SymbolId symbol_id;
 };
@@ -23,7 +23,9 @@ public:
     [[nodiscard]] llvm::Value* gen() override;
     [[nodiscard]] llvm::Type* gen_type() const override;
     [[nodiscard]] KType* get_ktype() const override;
-    [[nodiscard]] std::vector<ASTNode*> get_children() const override;
+    void for_each_child(ChildCallback fn) const override;
+
+    static bool classof(const ASTNode* node) { return node->get_kind() == Kind::AnonymousFunctionNode; }
 
 private:
     FunctionNode* function;
@@ -6,6 +6,7 @@
 
 class ModuleCompiler;
 class KType;
+struct SliceIndexFact;
 
 namespace llvm {
 class Value;
@@ -24,16 +25,23 @@ public:
     [[nodiscard]] llvm::Value* trivial_gen() override;
     [[nodiscard]] bool is_trivially_evaluable() const override;
 
-    [[nodiscard]] std::vector<ASTNode*> get_children() const override;
+    void for_each_child(ChildCallback fn) const override;
 
     [[nodiscard]] ExpressionNode* get_array() const { return array; }
     [[nodiscard]] ExpressionNode* get_index() const { return index; }
 
+    [[nodiscard]] bool is_mask_lane() const;
+    void gen_mask_lane_store(llvm::Value* value) const;
+
+    static bool classof(const ASTNode* node) { return node->get_kind() == Kind::ArrayIndexNode; }
+
 private:
     llvm::Value* gen_array_access() const;
     llvm::Value* gen_pointer_access() const;
     llvm::Value* gen_slice_access() const;
     llvm::Value* gen_slice_element_ptr() const;
+    llvm::Value* gen_lane_index() const;
+    const SliceIndexFact* find_slice_index_fact() const;
     void validate_index_type() const;
     KType* calculate_result_type() const;
 
@@ -8,6 +8,10 @@
 class ModuleCompiler;
 class KType;
 
+namespace llvm {
+class AllocaInst;
+}
+
 class ArrayNode : public ExpressionNode {
 public:
     ArrayNode(std::vector<ExpressionNode*> elements, KType* type, ModuleCompiler& compiler);
@@ -17,10 +21,15 @@ public:
     [[nodiscard]] llvm::Value* gen_ptr() const override;
     [[nodiscard]] llvm::Type* gen_type() const override;
     [[nodiscard]] KType* get_ktype() const override { return type; }
-    [[nodiscard]] std::vector<ASTNode*> get_children() const override;
+    void for_each_child(ChildCallback fn) const override;
+
+    // Initializes `destination` with the array, copying constant arrays out of the module's constant pool.
+    void gen_into(llvm::AllocaInst* destination);
 
     [[nodiscard]] const std::vector<ExpressionNode*>& get_elements() const { return elements; }
 
+    static bool classof(const ASTNode* node) { return node->get_kind() == Kind::ArrayNode; }
+
 private:
     void check_types() const;
 
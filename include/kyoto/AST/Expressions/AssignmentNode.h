@@ -6,6 +6,7 @@
 #include "kyoto/AST/ASTNode.h"
 #include "kyoto/AST/Expressions/ExpressionNode.h"
 
+class ArrayIndexNode;
 class ModuleCompiler;
 class KType;
 
@@ -27,10 +28,20 @@ public:
     [[nodiscard]] KType* get_ktype() const override;
     [[nodiscard]] bool is_trivially_evaluable() const override;
 
-    [[nodiscard]] std::vector<ASTNode*> get_children() const override { return { assignee, expr }; }
+    void for_each_child(ChildCallback fn) const override
+    {
+        fn(assignee);
+        fn(expr);
+    }
+
+    [[nodiscard]] ExpressionNode* get_assignee() const { return assignee; }
+    [[nodiscard]] ExpressionNode* get_expr() const { return expr; }
+
+    static bool classof(const ASTNode* node) { return node->get_kind() == Kind::AssignmentNode; }
 
 private:
     [[nodiscard]] llvm::Value* gen_deref_assignment() const;
+    [[nodiscard]] llvm::Value* gen_mask_lane_assignment(const ArrayIndexNode* lane) const;
     void validate_lvalue() const;
     [[nodiscard]] Symbol get_lhs_lvalue() const;
     [[nodiscard]] llvm::Value* generate_expression_value(const KType* type, const std::string& name) const;
@@ -22,13 +22,26 @@ class Value;
         std::string to_string() const override;                                   \
         llvm::Value* gen() override;                                              \
         llvm::Type* gen_type() const override;                                    \
-        [[nodiscard]] std::vector<ASTNode*> get_children() const override         \
+        void for_each_child(ChildCallback fn) const override                      \
         {                                                                         \
-            return { lhs, rhs };                                                  \
+            fn(lhs);                                                              \
+            fn(rhs);                                                              \
         }                                                                         \
         KType* get_ktype() const override;                                        \
         llvm::Value* trivial_gen() override;                                      \
         bool is_trivially_evaluable() const override;                             \
+        [[nodiscard]] ExpressionNode* get_lhs() const                             \
+        {                                                                         \
+            return lhs;                                                           \
+        }                                                                         \
+        [[nodiscard]] ExpressionNode* get_rhs() const                             \
+        {                                                                         \
+            return rhs;                                                           \
+        }                                                                         \
+        static bool classof(const ASTNode* node)                                  \
+        {                                                                         \
+            return node->get_kind() == Kind::name;                                \
+        }                                                                         \
     }
 
 BINARY_NODE_INTERFACE(AddNode);
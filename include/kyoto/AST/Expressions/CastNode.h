@@ -26,13 +26,17 @@ public:
     [[nodiscard]] llvm::Value* trivial_gen() override;
     [[nodiscard]] bool is_trivially_evaluable() const override;
 
-    [[nodiscard]] std::vector<ASTNode*> get_children() const override { return { expr }; }
+    void for_each_child(ChildCallback fn) const override { fn(expr); }
 
     [[nodiscard]] KType* get_type() const { return type; }
     [[nodiscard]] ExpressionNode* get_expr() const { return expr; }
 
+    static bool classof(const ASTNode* node) { return node->get_kind() == Kind::CastNode; }
+
 private:
     llvm::Value* handle_integer_cast();
+    llvm::Value* handle_vector_cast();
+    llvm::Value* convert_lanes(llvm::Value* value, const KType* from, const KType* to) const;
     void check_compatible_integer_cast(const PrimitiveType* expr_ktype, const PrimitiveType* target_type);
     void throw_incompatible_cast_error(const KType* expr_ktype, const KType* target_ktype) const;
 
@@ -25,11 +25,10 @@ public:
     [[nodiscard]] virtual bool is_trivially_evaluable() const { return false; }
     [[nodiscard]] virtual llvm::Value* gen_ptr() const { return nullptr; }
 
-    [[nodiscard]] virtual std::vector<ASTNode*> get_children() const = 0;
-
-    template <typename T> bool is() const { return dynamic_cast<const T*>(this) != nullptr; }
-
-    template <typename T> T* as() { return dynamic_cast<T*>(this); }
+    static bool classof(const ASTNode* node)
+    {
+        return node->get_kind() >= Kind::FirstExpression && node->get_kind() <= Kind::LastExpression;
+    }
 
     static void check_boolean_promotion(const PrimitiveType* expr_ktype, const PrimitiveType* target_type,
                                         const std::string& target_name);
@@ -50,4 +49,10 @@ public:
     static bool can_convert_array_to_slice(const KType* target_type, const KType* expr_type);
     static llvm::Value* convert_array_to_slice(ExpressionNode* expr, const KType* target_type,
                                                ModuleCompiler& compiler);
+
+protected:
+    explicit ExpressionNode(Kind kind)
+        : ASTNode(kind)
+    {
+    }
 };
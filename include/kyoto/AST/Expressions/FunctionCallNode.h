@@ -1,11 +1,13 @@
 #pragma once
 
+#include <optional>
 #include <stddef.h>
 #include <string>
 #include <vector>
 
 #include "kyoto/AST/ASTNode.h"
 #include "kyoto/AST/Expressions/ExpressionNode.h"
+#include "kyoto/SymbolTable.h"
 
 class ModuleCompiler;
 
@@ -34,24 +36,37 @@ public:
     void insert_arg(ExpressionNode* node, size_t index);
     void set_destination(llvm::Value* dest);
 
-    [[nodiscard]] std::vector<ASTNode*> get_children() const override;
+    void for_each_child(ChildCallback fn) const override;
 
     [[nodiscard]] bool is_constructor_call() const { return is_constructor; }
     void set_as_constructor_call()
     {
         is_constructor = true;
         name += "_constructor";
+        symbol_ids.reset();
     }
 
     void set_name_prefix(const std::string& prefix)
     {
         if (name.find(prefix) == 0) return;
         name = prefix + name;
+        symbol_ids.reset();
     }
 
-    void set_name(std::string new_name) { name = std::move(new_name); }
+    void set_name(std::string new_name)
+    {
+        name = std::move(new_name);
+        symbol_ids.reset();
+    }
+
+    static bool classof(const ASTNode* node)
+    {
+        return node->get_kind() >= Kind::FirstFunctionCall && node->get_kind() <= Kind::LastFunctionCall;
+    }
 
 protected:
+    FunctionCall(Kind kind, std::string name, std::vector<ExpressionNode*> args, ModuleCompiler& compiler);
+
     bool is_constructor { false };
     std::string name;
     ExpressionNode* callee = nullptr;
@@ -59,5 +74,16 @@ protected:
     ModuleCompiler& compiler;
 
 private:
+    // Looks `name` up as a local symbol, falling back to its unqualified part.
+    std::optional<Symbol> find_symbol() const;
+
+    // Interned ids of `name` and of its unqualified part, resolved on the first lookup and reset whenever `name`
+    // changes.
+    struct SymbolIds {
+        SymbolTable::SymbolId name;
+        std::optional<SymbolTable::SymbolId> unqualified;
+    };
+
     llvm::Value* destination = nullptr;
+    mutable std::optional<SymbolIds> symbol_ids;
 };
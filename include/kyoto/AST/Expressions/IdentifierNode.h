@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "kyoto/AST/Expressions/ExpressionNode.h"
+#include "kyoto/SymbolTable.h"
 
 class ModuleCompiler;
 
@@ -19,12 +20,16 @@ public:
     [[nodiscard]] llvm::Type* gen_type() const override;
     [[nodiscard]] KType* get_ktype() const override;
 
-    [[nodiscard]] std::vector<ASTNode*> get_children() const override { return {}; }
+    void for_each_child(ChildCallback) const override { }
 
     [[nodiscard]] const std::string& get_name() const { return name; }
+    [[nodiscard]] SymbolTable::SymbolId get_symbol_id() const { return symbol_id; }
+
+    static bool classof(const ASTNode* node) { return node->get_kind() == Kind::IdentifierExpressionNode; }
 
 private:
     std::string name;
     ModuleCompiler& compiler;
+    SymbolTable::SymbolId symbol_id;
     mutable std::unique_ptr<KType> resolved_function_type;
 };
@@ -27,14 +27,19 @@ public:
     [[nodiscard]] llvm::Value* gen() override;
     [[nodiscard]] llvm::Type* gen_type() const override;
     [[nodiscard]] KType* get_ktype() const override;
-    [[nodiscard]] std::vector<ASTNode*> get_children() const override;
+    void for_each_child(ChildCallback fn) const override;
 
     [[nodiscard]] llvm::Value* gen_default_only();
 
+    static bool classof(const ASTNode* node) { return node->get_kind() == Kind::MatchNode; }
+
 private:
     void check_types() const;
+    void check_duplicate_cases() const;
     void validate_default();
     void init_ktype() const;
+    [[nodiscard]] bool can_gen_switch() const;
+    [[nodiscard]] llvm::Value* gen_switch();
     [[nodiscard]] llvm::Value* gen_cmp(ExpressionNode* lhs, ExpressionNode* rhs);
 
 private:
@@ -13,6 +13,7 @@ class Type;
 class ModuleCompiler;
 class KType;
 class ClassMetadata;
+class DeclarationStatementNode;
 
 class MemberAccessNode : public ExpressionNode {
 public:
@@ -30,14 +31,16 @@ public:
     [[nodiscard]] const std::string& get_member() const { return member; }
     [[nodiscard]] ExpressionNode* get_lhs() const { return lhs; }
 
-    [[nodiscard]] std::vector<ASTNode*> get_children() const override { return { lhs }; }
+    void for_each_child(ChildCallback fn) const override { fn(lhs); }
+
+    static bool classof(const ASTNode* node) { return node->get_kind() == Kind::MemberAccessNode; }
 
 private:
     void validate_member_access(KType* lhs_type) const;
     std::string get_class_name(KType* lhs_type) const;
     llvm::Type* get_class_type(KType* lhs_type) const;
     unsigned get_member_index(KType* lhs_type) const;
-    const ASTNode* get_member_declaration(const ClassMetadata& class_metadata) const;
+    const DeclarationStatementNode* get_member_declaration(const ClassMetadata& class_metadata) const;
 
 private:
     ExpressionNode* lhs;
@@ -7,6 +7,7 @@
 
 class ModuleCompiler;
 class ExpressionNode;
+class VectorReduceNode;
 
 class MethodCall : public FunctionCall {
 public:
@@ -23,12 +24,16 @@ public:
     [[nodiscard]] bool is_trivially_evaluable() const override;
 
     [[nodiscard]] const std::string& get_instance_name() const { return instance_text; }
-    [[nodiscard]] std::vector<ASTNode*> get_children() const override;
+    void for_each_child(ChildCallback fn) const override;
 
     void prepare_call() const;
 
+    static bool classof(const ASTNode* node) { return node->get_kind() == Kind::MethodCall; }
+
 private:
     mutable ExpressionNode* instance;
     std::string instance_text;
     mutable bool prepared = false;
+    // Set instead of a call when the instance is a vector: its methods are the horizontal reductions.
+    mutable VectorReduceNode* reduction = nullptr;
 };
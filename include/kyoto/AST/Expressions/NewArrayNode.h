@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -11,7 +12,12 @@ class ModuleCompiler;
 
 class NewArrayNode : public ExpressionNode {
 public:
-    NewArrayNode(KType* type, ExpressionNode* size_expr, ModuleCompiler& compiler);
+    // Alignments larger than a page are rejected by the parser.
+    static constexpr uint64_t max_align = 4096;
+
+    // `align` of 0 keeps the element type's own alignment; `zeroed` arrays start out filled with zero bytes.
+    NewArrayNode(KType* type, ExpressionNode* size_expr, ModuleCompiler& compiler, uint64_t align = 0,
+                 bool zeroed = false);
 
     ~NewArrayNode() override;
 
@@ -29,11 +35,19 @@ public:
 
     [[nodiscard]] ExpressionNode* get_size_expr() const { return size_expr; }
 
-    [[nodiscard]] std::vector<ASTNode*> get_children() const override { return { size_expr }; }
+    [[nodiscard]] uint64_t get_align() const { return align; }
+
+    [[nodiscard]] bool is_zeroed() const { return zeroed; }
+
+    void for_each_child(ChildCallback fn) const override { fn(size_expr); }
+
+    static bool classof(const ASTNode* node) { return node->get_kind() == Kind::NewArrayNode; }
 
 private:
     KType* type;
     KType* generated_type;
     ExpressionNode* size_expr;
+    uint64_t align;
+    bool zeroed;
     ModuleCompiler& compiler;
 };
\ No newline at end of file
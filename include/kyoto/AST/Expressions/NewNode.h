@@ -24,11 +24,13 @@ public:
     [[nodiscard]] llvm::Value* trivial_gen() override;
     [[nodiscard]] bool is_trivially_evaluable() const override;
 
-    [[nodiscard]] std::vector<ASTNode*> get_children() const override { return { constructor_call }; }
+    void for_each_child(ChildCallback fn) const override { fn(constructor_call); }
 
     [[nodiscard]] KType* get_type() const { return type; }
     [[nodiscard]] FunctionCall* get_constructor_call() const { return constructor_call; }
 
+    static bool classof(const ASTNode* node) { return node->get_kind() == Kind::NewNode; }
+
 private:
     KType* type;
     KType* generated_type;
@@ -25,8 +25,10 @@ public:
     [[nodiscard]] KType* get_ktype() const override;
     [[nodiscard]] bool is_trivially_evaluable() const override;
 
-    [[nodiscard]] std::vector<ASTNode*> get_children() const override { return {}; }
+    void for_each_child(ChildCallback) const override { }
     [[nodiscard]] int64_t get_value() const { return value; }
 
     void cast_to(PrimitiveType::Kind target_type);
+
+    static bool classof(const ASTNode* node) { return node->get_kind() == Kind::NumberNode; }
 };
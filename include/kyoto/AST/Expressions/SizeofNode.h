@@ -24,12 +24,14 @@ public:
     [[nodiscard]] KType* get_ktype() const override;
     [[nodiscard]] llvm::Value* trivial_gen() override;
     [[nodiscard]] bool is_trivially_evaluable() const override;
-    [[nodiscard]] std::vector<ASTNode*> get_children() const override;
+    void for_each_child(ChildCallback fn) const override;
 
     [[nodiscard]] OperandType get_operand_type() const { return operand_type; }
     [[nodiscard]] ExpressionNode* get_expr() const { return expr; }
     [[nodiscard]] KType* get_type() const { return type; }
 
+    static bool classof(const ASTNode* node) { return node->get_kind() == Kind::SizeofNode; }
+
 private:
     OperandType operand_type;
     ExpressionNode* expr;
@@ -18,7 +18,9 @@ public:
     [[nodiscard]] KType* get_ktype() const override;
     [[nodiscard]] llvm::Value* trivial_gen() override;
     [[nodiscard]] bool is_trivially_evaluable() const override;
-    [[nodiscard]] std::vector<ASTNode*> get_children() const override;
+    void for_each_child(ChildCallback fn) const override;
+
+    static bool classof(const ASTNode* node) { return node->get_kind() == Kind::SliceNode; }
 
 private:
     void validate() const;
@@ -20,10 +20,12 @@ public:
     [[nodiscard]] llvm::Value* trivial_gen() override;
     [[nodiscard]] bool is_trivially_evaluable() const override;
 
-    [[nodiscard]] std::vector<ASTNode*> get_children() const override { return {}; }
+    void for_each_child(ChildCallback) const override { }
 
     void cast_to(PrimitiveType::Kind target_type);
 
+    static bool classof(const ASTNode* node) { return node->get_kind() == Kind::StringLiteralNode; }
+
 private:
     mutable KType* type;
     std::string value;
@@ -34,11 +34,13 @@ public:
     [[nodiscard]] KType* get_ktype() const override;
     [[nodiscard]] llvm::Value* trivial_gen() override;
     [[nodiscard]] bool is_trivially_evaluable() const override;
-    [[nodiscard]] std::vector<ASTNode*> get_children() const override { return { expr }; }
+    void for_each_child(ChildCallback fn) const override { fn(expr); }
 
     [[nodiscard]] ExpressionNode* get_expr() const { return expr; }
     [[nodiscard]] UnaryOp get_op() const { return op; }
 
+    static bool classof(const ASTNode* node) { return node->get_kind() == Kind::UnaryNode; }
+
 private:
     std::string op_to_string() const;
     bool simple_op() const;
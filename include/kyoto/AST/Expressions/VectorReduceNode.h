@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+
+#include "kyoto/AST/ASTNode.h"
+#include "kyoto/AST/Expressions/ExpressionNode.h"
+
+namespace llvm {
+class Type;
+}
+
+class ModuleCompiler;
+class KType;
+class VectorType;
+
+// Horizontal reduction of a vector to one lane, written as a method call: `v.sum()`, `v.product()`, `v.min()` and
+// `v.max()` on numeric vectors, `m.any()` and `m.all()` on boolean masks.
+class VectorReduceNode : public ExpressionNode {
+public:
+    VectorReduceNode(ExpressionNode* vector, std::string op, ModuleCompiler& compiler);
+    ~VectorReduceNode();
+
+    [[nodiscard]] std::string to_string() const override;
+    [[nodiscard]] llvm::Value* gen() override;
+    [[nodiscard]] llvm::Value* gen_ptr() const override;
+    [[nodiscard]] llvm::Type* gen_type() const override;
+    [[nodiscard]] KType* get_ktype() const override;
+
+    [[nodiscard]] const std::string& get_op() const { return op; }
+    [[nodiscard]] ExpressionNode* get_vector() const { return vector; }
+
+    void for_each_child(ChildCallback fn) const override { fn(vector); }
+
+    static bool classof(const ASTNode* node) { return node->get_kind() == Kind::VectorReduceNode; }
+
+private:
+    [[nodiscard]] const VectorType* get_vector_type() const;
+
+private:
+    ExpressionNode* vector;
+    std::string op;
+    ModuleCompiler& compiler;
+};
@@ -20,7 +20,14 @@ public:
     [[nodiscard]] std::string to_string() const override;
     [[nodiscard]] llvm::Value* gen() override;
 
-    [[nodiscard]] std::vector<ASTNode*> get_children() const override;
+    void for_each_child(ChildCallback fn) const override;
+
+    [[nodiscard]] ASTNode* get_init() const { return init; }
+    [[nodiscard]] ExpressionStatementNode* get_condition() const { return condition; }
+    [[nodiscard]] ExpressionNode* get_update() const { return update; }
+    [[nodiscard]] ASTNode* get_body() const { return body; }
+
+    static bool classof(const ASTNode* node) { return node->get_kind() == Kind::ForStatementNode; }
 
 private:
     void handle_init() const;
@@ -16,10 +16,12 @@ public:
     [[nodiscard]] std::string to_string() const override;
     [[nodiscard]] llvm::Value* gen() override;
 
-    [[nodiscard]] std::vector<ASTNode*> get_children() const override;
+    void for_each_child(ChildCallback fn) const override;
 
     bool has_else() const { return conditions.size() != bodies.size(); }
 
+    static bool classof(const ASTNode* node) { return node->get_kind() == Kind::IfStatementNode; }
+
 private:
     std::vector<ExpressionNode*> conditions;
     std::vector<ASTNode*> bodies;
@@ -20,10 +20,13 @@ public:
 
     [[nodiscard]] std::string to_string() const override;
     [[nodiscard]] llvm::Value* gen() override;
-    [[nodiscard]] std::vector<ASTNode*> get_children() const override;
+    void for_each_child(ChildCallback fn) const override;
+
+    static bool classof(const ASTNode* node) { return node->get_kind() == Kind::ReturnStatementNode; }
 
 private:
     void validate_void_return() const;
+    void release_arenas() const;
     llvm::Value* generate_return_value() const;
     bool are_compatible_integers_or_booleans() const;
     bool are_compatible_pointer_types() const;
@@ -15,11 +15,13 @@ public:
 
     [[nodiscard]] std::string to_string() const override;
     [[nodiscard]] llvm::Value* gen() override;
-    [[nodiscard]] std::vector<ASTNode*> get_children() const override { return {}; }
+    void for_each_child(ChildCallback) const override { }
 
     [[nodiscard]] KType* get_original_type() const { return originalType; }
     [[nodiscard]] std::string get_alias() const { return alias; }
 
+    static bool classof(const ASTNode* node) { return node->get_kind() == Kind::TypeAliasNode; }
+
 private:
     KType* originalType;
     std::string alias;
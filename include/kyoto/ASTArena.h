@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stddef.h>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "llvm/Support/Allocator.h"
+
+#include "kyoto/AST/ASTNode.h"
+#include "kyoto/KType.h"
+
+// Bump-pointer region holding the AST nodes and KTypes built for one module. Objects made here ignore `delete`, so the
+// owning destructors nodes keep for heap-allocated children need no special casing; everything is destroyed and its
+// memory released together when the arena dies.
+class ASTArena {
+public:
+    ASTArena() = default;
+    ASTArena(const ASTArena&) = delete;
+    ASTArena& operator=(const ASTArena&) = delete;
+    ~ASTArena();
+
+    template <typename T, typename... Args> T* make(Args&&... args)
+    {
+        static_assert(std::is_base_of_v<ASTNode, T> || std::is_base_of_v<KType, T>);
+        auto* object = new (allocator.Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        object->arena_allocated = true;
+        destructors.push_back({ object, [](void* p) { static_cast<T*>(p)->~T(); } });
+        return object;
+    }
+
+    [[nodiscard]] size_t get_bytes_allocated() const { return allocator.getBytesAllocated(); }
+
+private:
+    struct Destructor {
+        void* object;
+        void (*destroy)(void*);
+    };
+
+    llvm::BumpPtrAllocator allocator;
+    std::vector<Destructor> destructors;
+};
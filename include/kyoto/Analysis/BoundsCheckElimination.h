@@ -0,0 +1,23 @@
+#pragma once
+
+#include <optional>
+
+class ForStatementNode;
+class ModuleCompiler;
+
+namespace llvm {
+class AllocaInst;
+}
+
+// States that, for the whole body of a loop, the value held in `index` is below the size of the slice held in
+// `slice`. When `non_negative` is false the index may still wrap below zero, so the lower-bound check stays.
+struct SliceIndexFact {
+    llvm::AllocaInst* index;
+    llvm::AllocaInst* slice;
+    bool non_negative;
+};
+
+// Recognizes `for (var i = <c>; i < s.size; ++i)` loops (with `c >= 0`) whose body never writes to `i` or `s`, in
+// functions that never take the address of either.
+// Must be called after the loop's init has been generated so that `i` resolves to its stack slot.
+std::optional<SliceIndexFact> analyze_slice_induction(const ForStatementNode& loop, ModuleCompiler& compiler);
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+
+#if __has_include("llvm/IR/Analysis.h")
+#include "llvm/IR/Analysis.h"
+#endif
+#include "llvm/IR/PassManager.h"
+
+class ModuleCompiler;
+
+namespace llvm {
+class Module;
+}
+
+// Metadata attached to the `malloc` call of every `new T(...)`, holding the name of the allocated class.
+inline constexpr auto* new_allocation_metadata = "kyoto.new";
+
+// Turns `new` allocations whose pointer never leaves the allocating function into entry-block allocas and drops the
+// `free` calls made on them. Allocations inside loops are left alone, as one stack slot cannot hold an object per
+// iteration.
+struct HeapToStackPass : llvm::PassInfoMixin<HeapToStackPass> {
+    // Larger objects stay on the heap so that recursion cannot blow up the stack.
+    static constexpr uint64_t max_stack_bytes = 4096;
+
+    explicit HeapToStackPass(ModuleCompiler& compiler);
+
+    llvm::PreservedAnalyses run(llvm::Module& module, llvm::ModuleAnalysisManager& MAM);
+
+private:
+    ModuleCompiler& compiler;
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+class ModuleCompiler;
+
+namespace llvm {
+class AllocaInst;
+class Value;
+}
+
+// Bump-pointer arenas backing `with arena { ... }`. An arena is a chain of malloc'd chunks that objects are carved out
+// of in order; nothing is freed until the whole arena is released. The runtime is emitted into the module as private
+// functions, so compiled and JIT-run programs need no extra library.
+
+// Creates an empty arena in the entry block of the function being generated.
+llvm::AllocaInst* create_arena(ModuleCompiler& compiler);
+
+llvm::Value* gen_arena_alloc(ModuleCompiler& compiler, llvm::Value* arena, llvm::Value* size, uint64_t align);
+
+void gen_arena_release(ModuleCompiler& compiler, llvm::Value* arena);
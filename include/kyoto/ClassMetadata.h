@@ -2,6 +2,8 @@
 
 #include <optional>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "kyoto/AST/ASTNode.h"
@@ -14,19 +16,30 @@ class StructType;
 }
 
 struct ClassMetadata {
+    struct Field {
+        size_t index;
+        DeclarationStatementNode* declaration;
+    };
+
     llvm::StructType* llvm_type;
     ClassDefinitionNode* node;
+    // Filled once by ClassIdentifierVisitor. Fields map to their struct index; methods are recorded by the name they
+    // are declared with inside the class, without the class prefix. Overloads are resolved with the other functions.
+    std::unordered_map<std::string, Field> fields {};
+    std::unordered_set<std::string> method_names {};
 
     [[nodiscard]] std::optional<size_t> member_idx(const std::string& name) const
     {
-        for (size_t i = 0; i < node->get_children().size(); ++i) {
-            if (node->get_children()[i]->is<DeclarationStatementNode>()) {
-                auto* decl = node->get_children()[i]->as<DeclarationStatementNode>();
-                if (decl->get_name() == name) {
-                    return i;
-                }
-            }
-        }
-        return {};
+        const auto it = fields.find(name);
+        if (it == fields.end()) return {};
+        return it->second.index;
     }
-};
\ No newline at end of file
+
+    [[nodiscard]] DeclarationStatementNode* get_field(const std::string& name) const
+    {
+        const auto it = fields.find(name);
+        return it == fields.end() ? nullptr : it->second.declaration;
+    }
+
+    [[nodiscard]] bool has_method(const std::string& name) const { return method_names.contains(name); }
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+
+enum class OptLevel {
+    O0,
+    O1,
+    O2,
+    O3,
+    Os,
+};
+
+enum class BoundsCheckMode {
+    On,
+    Off,
+    TrapOnly,
+};
+
+enum class AllocMode {
+    Malloc,
+    Pool,
+};
+
+struct CompilerOptions {
+    // Unoptimized unless asked otherwise, which keeps the IR seen by tests close to what was generated. The driver
+    // picks O2 for the programs it builds.
+    OptLevel opt_level = OptLevel::O0;
+    BoundsCheckMode bounds_checks = BoundsCheckMode::On;
+    AllocMode alloc = AllocMode::Malloc;
+    // Report the optimizations done by the Kyoto passes on stderr.
+    bool opt_remarks = false;
+    // Threads used to parse imported modules; 0 uses every hardware thread.
+    unsigned jobs = 0;
+    // When set, optimized bitcode of imported modules is reused from (and written to) this directory.
+    std::optional<std::filesystem::path> cache_dir;
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <format>
+#include <new>
 #include <stddef.h>
 #include <stdexcept>
 #include <string>
@@ -11,16 +12,29 @@ namespace llvm {
 class Type;
 }
 
+class TypeContext;
+
 class KType {
 public:
+    // Tag of the concrete subclass, used for LLVM-style classof/isa instead of dynamic_cast.
+    enum class TypeKind { Primitive, Pointer, Class, Array, Slice, Function, Vector };
+
     virtual ~KType() = default;
+
+    // Interned types are owned by their TypeContext and arena types by their ASTArena, so a `delete` from any other
+    // owner leaves them alive.
+    void operator delete(KType* type, std::destroying_delete_t);
+
+    [[nodiscard]] bool is_interned() const { return interned; }
     [[nodiscard]] virtual std::string to_string() const = 0;
-    [[nodiscard]] virtual bool is_primitive() const { return false; }
-    [[nodiscard]] virtual bool is_pointer() const { return false; }
-    [[nodiscard]] virtual bool is_array() const { return false; }
-    [[nodiscard]] virtual bool is_slice() const { return false; }
-    [[nodiscard]] virtual bool is_class() const { return false; }
-    [[nodiscard]] virtual bool is_function() const { return false; }
+    [[nodiscard]] TypeKind get_type_kind() const { return type_kind; }
+    [[nodiscard]] bool is_primitive() const { return type_kind == TypeKind::Primitive; }
+    [[nodiscard]] bool is_pointer() const { return type_kind == TypeKind::Pointer; }
+    [[nodiscard]] bool is_array() const { return type_kind == TypeKind::Array; }
+    [[nodiscard]] bool is_slice() const { return type_kind == TypeKind::Slice; }
+    [[nodiscard]] bool is_class() const { return type_kind == TypeKind::Class; }
+    [[nodiscard]] bool is_function() const { return type_kind == TypeKind::Function; }
+    [[nodiscard]] bool is_vector() const { return type_kind == TypeKind::Vector; }
     [[nodiscard]] virtual bool is_void() const { return false; }
     [[nodiscard]] virtual bool is_string() const { return false; }
     [[nodiscard]] virtual bool is_integer() const { return false; }
@@ -35,32 +49,45 @@ public:
     }
 
     [[nodiscard]] virtual KType* copy() const = 0;
-    virtual bool operator==(const KType& other) const = 0;
-    virtual bool operator!=(const KType& other) const { return !(*this == other); }
+    bool operator==(const KType& other) const;
+    bool operator!=(const KType& other) const { return !(*this == other); }
 
     static KType* get_void();
 
-    template <typename T> [[nodiscard]] bool is() const { return dynamic_cast<const T*>(this) != nullptr; }
+    template <typename T> [[nodiscard]] bool is() const { return T::classof(this); }
 
     template <typename T> T* as()
     {
-        auto* ptr = dynamic_cast<T*>(this);
-        if (!ptr) {
+        if (!is<T>()) {
             throw std::runtime_error(std::format("KType::as: Cannot cast {} to {}", to_string(), typeid(T).name()));
         }
-        return ptr;
+        return static_cast<T*>(this);
     }
 
     template <typename T> const T* as() const
     {
-        auto* ptr = dynamic_cast<const T*>(this);
-        if (!ptr) {
+        if (!is<T>()) {
             throw std::runtime_error(std::format("KType::as: Cannot cast {} to {}", to_string(), typeid(T).name()));
         }
-        return ptr;
+        return static_cast<const T*>(this);
+    }
+
+    static KType* from_llvm_type(const llvm::Type* type, TypeContext& types);
+
+protected:
+    explicit KType(TypeKind type_kind)
+        : type_kind(type_kind)
+    {
     }
 
-    static KType* from_llvm_type(const llvm::Type* type);
+    [[nodiscard]] virtual bool equals(const KType& other) const = 0;
+
+private:
+    friend class ASTArena;
+    friend class TypeContext;
+    const TypeKind type_kind;
+    bool interned = false;
+    bool arena_allocated = false;
 };
 
 class PrimitiveType : public KType {
@@ -69,8 +96,7 @@ public:
 
     explicit PrimitiveType(Kind kind);
     [[nodiscard]] std::string to_string() const override;
-    [[nodiscard]] bool is_primitive() const override;
-    bool operator==(const KType& other) const override;
+    [[nodiscard]] bool equals(const KType& other) const override;
     [[nodiscard]] KType* copy() const override;
 
     [[nodiscard]] bool is_integer() const override;
@@ -84,6 +110,8 @@ public:
 
     [[nodiscard]] Kind get_kind() const;
 
+    static bool classof(const KType* type) { return type->get_type_kind() == TypeKind::Primitive; }
+
 private:
     Kind kind;
 };
@@ -93,15 +121,16 @@ public:
     explicit PointerType(KType* pointee);
     ~PointerType() override;
     [[nodiscard]] std::string to_string() const override;
-    bool operator==(const KType& other) const override;
+    [[nodiscard]] bool equals(const KType& other) const override;
     [[nodiscard]] KType* copy() const override;
 
     [[nodiscard]] KType* get_pointee() const;
     [[nodiscard]] bool is_string() const override;
-    [[nodiscard]] bool is_pointer() const override;
     [[nodiscard]] bool is_pointer_to_class(const std::string& name) const override;
     [[nodiscard]] std::string get_class_name() const override;
 
+    static bool classof(const KType* type) { return type->get_type_kind() == TypeKind::Pointer; }
+
 private:
     KType* pointee;
 };
@@ -111,11 +140,12 @@ public:
     explicit ClassType(std::string name);
     ~ClassType() override;
     [[nodiscard]] std::string to_string() const override;
-    [[nodiscard]] bool is_class() const override;
-    bool operator==(const KType& other) const override;
+    [[nodiscard]] bool equals(const KType& other) const override;
     [[nodiscard]] KType* copy() const override;
     [[nodiscard]] std::string get_class_name() const override;
 
+    static bool classof(const KType* type) { return type->get_type_kind() == TypeKind::Class; }
+
 private:
     std::string name;
 };
@@ -125,14 +155,15 @@ public:
     explicit ArrayType(KType* element_type, size_t n = 0);
     ~ArrayType() override;
     [[nodiscard]] std::string to_string() const override;
-    bool operator==(const KType& other) const override;
+    [[nodiscard]] bool equals(const KType& other) const override;
     [[nodiscard]] KType* copy() const override;
-    [[nodiscard]] bool is_array() const override;
     [[nodiscard]] size_t get_size() const;
     void set_size(size_t n);
 
     [[nodiscard]] KType* get_element_type() const;
 
+    static bool classof(const KType* type) { return type->get_type_kind() == TypeKind::Array; }
+
 private:
     KType* element_type;
     size_t size;
@@ -143,14 +174,39 @@ public:
     explicit SliceType(KType* element_type);
     ~SliceType() override;
     [[nodiscard]] std::string to_string() const override;
-    bool operator==(const KType& other) const override;
+    [[nodiscard]] bool equals(const KType& other) const override;
     [[nodiscard]] KType* copy() const override;
-    [[nodiscard]] bool is_slice() const override;
 
     [[nodiscard]] KType* get_element_type() const;
 
+    static bool classof(const KType* type) { return type->get_type_kind() == TypeKind::Slice; }
+
+private:
+    KType* element_type;
+};
+
+// A fixed number of lanes of one integer, floating point or boolean type, lowered to an LLVM `<N x T>` vector.
+// Boolean vectors are the lane masks produced by comparing vectors.
+class VectorType : public KType {
+public:
+    // Lane counts accepted in type names such as `i32x8`.
+    static constexpr size_t min_lanes = 2;
+    static constexpr size_t max_lanes = 64;
+
+    VectorType(KType* element_type, size_t lanes);
+    ~VectorType() override;
+    [[nodiscard]] std::string to_string() const override;
+    [[nodiscard]] bool equals(const KType& other) const override;
+    [[nodiscard]] KType* copy() const override;
+
+    [[nodiscard]] KType* get_element_type() const;
+    [[nodiscard]] size_t get_lanes() const;
+
+    static bool classof(const KType* type) { return type->get_type_kind() == TypeKind::Vector; }
+
 private:
     KType* element_type;
+    size_t lanes;
 };
 
 class FunctionType : public KType {
@@ -158,13 +214,14 @@ public:
     FunctionType(std::vector<KType*> param_types, KType* return_type);
     ~FunctionType() override;
     [[nodiscard]] std::string to_string() const override;
-    bool operator==(const KType& other) const override;
+    [[nodiscard]] bool equals(const KType& other) const override;
     [[nodiscard]] KType* copy() const override;
-    [[nodiscard]] bool is_function() const override;
 
     [[nodiscard]] const std::vector<KType*>& get_param_types() const;
     [[nodiscard]] KType* get_return_type() const;
 
+    static bool classof(const KType* type) { return type->get_type_kind() == TypeKind::Function; }
+
 private:
     std::vector<KType*> param_types;
     KType* return_type;
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace llvm {
+class LLVMContext;
+class Module;
+}
+
+// A persistent store of optimized per-module bitcode. Entries are keyed on a hash of everything that can change the
+// generated code (see `ModuleCompiler::compute_cache_key`), so stale entries are never read and need no invalidation.
+class ModuleCache {
+public:
+    explicit ModuleCache(std::filesystem::path directory);
+
+    static std::filesystem::path default_directory();
+    static std::string compiler_version();
+
+    [[nodiscard]] std::unique_ptr<llvm::Module> load(uint64_t key, llvm::LLVMContext& context) const;
+    bool store(uint64_t key, const llvm::Module& module) const;
+
+private:
+    [[nodiscard]] std::filesystem::path entry_path(uint64_t key) const;
+
+    std::filesystem::path directory;
+};
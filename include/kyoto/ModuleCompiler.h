@@ -1,30 +1,51 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <format>
+#include <functional>
 #include <llvm/IR/DataLayout.h>
+#include <map>
 #include <memory>
 #include <optional>
 #include <set>
 #include <string>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
+#include "KyotoParser.h"
+#include "kyoto/ASTArena.h"
+#include "kyoto/Analysis/BoundsCheckElimination.h"
 #include "kyoto/ClassMetadata.h"
+#include "kyoto/CompilerOptions.h"
+#include "kyoto/ModuleCache.h"
 #include "kyoto/Resolution/AnalysisVisitor.h"
 #include "kyoto/SymbolTable.h"
+#include "kyoto/TypeContext.h"
 #include "kyoto/TypeResolver.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
+#include "llvm/IR/PassManager.h"
+#include "llvm/Target/TargetMachine.h"
 
 class ASTNode;
 class FunctionNode;
 class KType;
+struct ParsedModule;
 
 namespace llvm {
+class AllocaInst;
+class Constant;
+class GlobalVariable;
+class PassBuilder;
 class raw_string_ostream;
 class BasicBlock;
 class Function;
@@ -33,10 +54,28 @@ class StructType;
 
 class ModuleCompiler {
 public:
+    enum class EmitKind {
+        IR,
+        Bitcode,
+        Assembly,
+        Object,
+    };
+
+    using PassBuilderCallback = std::function<void(llvm::PassBuilder&)>;
+
     explicit ModuleCompiler(const std::string& code, const std::string& name = "main",
-                            std::optional<std::filesystem::path> entry_path = std::nullopt);
+                            std::optional<std::filesystem::path> entry_path = std::nullopt,
+                            CompilerOptions options = {});
 
+    bool gen_module();
     std::optional<std::string> gen_ir();
+    std::optional<int32_t> run_jit();
+    bool emit(EmitKind kind, const std::filesystem::path& output_path);
+
+    const CompilerOptions& get_options() const { return options; }
+    const llvm::DataLayout& get_data_layout() const { return data_layout; }
+    void remark(const std::string& msg) const;
+    void register_pass_callback(PassBuilderCallback callback) { pass_callbacks.push_back(std::move(callback)); }
 
     llvm::LLVMContext& get_context() { return context; }
 
@@ -48,15 +87,27 @@ public:
     const std::filesystem::path& get_source_path() const { return current_source_path; }
     const std::string& get_current_module_name() const { return current_module_name; }
     TypeResolver& get_type_resolver() { return type_resolver; }
+    TypeContext& get_type_context() { return type_context; }
+    ASTArena& get_ast_arena();
 
+    // Nodes intern the names they look up once, so lookups during codegen do not hash strings.
+    SymbolTable::SymbolId intern_symbol(const std::string& name);
     std::optional<Symbol> get_symbol(const std::string& name);
+    std::optional<Symbol> get_symbol(SymbolTable::SymbolId id);
     void add_symbol(const std::string& name, Symbol symbol);
+    void add_symbol(SymbolTable::SymbolId id, Symbol symbol);
 
     void add_function(FunctionNode* node);
     std::optional<FunctionNode*> get_function(const std::string& name);
     std::optional<FunctionNode*> get_function(const std::string& name, size_t arity);
     std::vector<FunctionNode*> get_functions(const std::string& name, size_t arity) const;
     std::optional<FunctionNode*> get_external_varargs_function(const std::string& name, size_t arity) const;
+
+    // What overload resolution looks at for each argument: its interned type and whether it is trivially evaluable.
+    using CallSignature = std::vector<std::pair<const KType*, bool>>;
+    std::optional<FunctionNode*> get_resolved_call(const std::string& name, size_t param_offset,
+                                                   const CallSignature& signature) const;
+    void cache_resolved_call(const std::string& name, size_t param_offset, CallSignature signature, FunctionNode* fn);
     std::string get_function_llvm_name(const FunctionNode* node) const;
     std::string qualify_local_name(const std::string& name) const;
     std::string qualify_imported_name(const std::string& module_name, const std::string& name) const;
@@ -91,6 +142,23 @@ public:
 
     void insert_dummy_return(llvm::BasicBlock& bb);
     llvm::BasicBlock* create_basic_block(const std::string& name);
+    llvm::AllocaInst* create_entry_block_alloca(llvm::Type* type, const std::string& name);
+
+    // Module-wide pool of read-only data. LLVM uniques constants, so every occurrence of an equal constant shares one
+    // private unnamed_addr global.
+    llvm::GlobalVariable* get_constant_global(llvm::Constant* value, const std::string& name = ".const");
+    llvm::GlobalVariable* get_string_constant(const std::string& value);
+
+    void push_slice_index_fact(const SliceIndexFact& fact) { slice_index_facts.push_back(fact); }
+    void pop_slice_index_fact() { slice_index_facts.pop_back(); }
+    const SliceIndexFact* find_slice_index_fact(const llvm::AllocaInst* index, const llvm::AllocaInst* slice) const;
+
+    // `with arena` blocks being generated. Only the ones of the current function are visible, as anonymous functions
+    // are generated in the middle of their enclosing function.
+    void push_arena(llvm::AllocaInst* arena) { arenas.push_back(arena); }
+    void pop_arena() { arenas.pop_back(); }
+    llvm::AllocaInst* get_current_arena() const;
+    std::vector<llvm::AllocaInst*> get_function_arenas() const;
 
     void register_type_alias(const std::string& alias, KType* type);
     KType* resolve_type_alias(const std::string& alias);
@@ -100,15 +168,15 @@ public:
     void push_type_alias_scope();
     void pop_type_alias_scope();
 
+    // A generic class is kept as its parse subtree; `source` keeps the owning module's tree alive.
     struct TemplateMetadata {
         std::string param;
-        std::string raw_text;
+        kyoto::KyotoParser::ClassDefinitionContext* definition;
+        std::shared_ptr<ParsedModule> source;
     };
-    void register_template(const std::string& name, const std::string& param, const std::string& raw_text)
-    {
-        template_registry[name] = { param, raw_text };
-    }
-    void instantiate_template(const std::string& name, const std::string& mangled_name, const std::string& type_str);
+    void register_template(const std::string& name, const std::string& param,
+                           kyoto::KyotoParser::ClassDefinitionContext* definition);
+    void instantiate_template(const std::string& name, const std::string& mangled_name, const KType* argument);
     std::vector<ASTNode*>& get_instantiated_nodes() { return instantiated_nodes; }
 
     void set_building_top_level(bool value) { building_top_level = value; }
@@ -116,19 +184,28 @@ public:
 
 private:
     bool verify_module(llvm::raw_string_ostream& os) const;
-    ASTNode* parse_program(const std::string& source);
+    ASTNode* build_program_ast(ParsedModule& parsed);
     void ensure_main_fn() const;
     void llvm_pass();
+    void optimize_module(llvm::Module& target);
+    void run_module_pipeline(llvm::Module& target,
+                             const std::function<llvm::ModulePassManager(llvm::PassBuilder&)>& build_pipeline);
+    uint64_t compute_cache_key(const std::string& module_name,
+                               const std::unordered_map<std::string, uint64_t>& import_keys) const;
+    std::vector<std::unique_ptr<llvm::Module>>
+    split_cached_modules(const std::vector<std::string>& module_order,
+                         const std::vector<std::vector<llvm::Function*>>& owned_functions);
+    std::unique_ptr<llvm::Module> extract_module_unit(const std::string& module_name,
+                                                      const std::vector<llvm::Function*>& functions) const;
     void load_modules();
-    void load_module_recursive(const std::string& module_name, const std::filesystem::path& path,
-                               const std::string* source, std::vector<std::string>& stack);
-    std::vector<std::string> parse_imports(const std::string& source, const std::filesystem::path& path) const;
     std::unique_ptr<ASTNode> build_module_ast(const std::string& module_name);
     std::vector<std::string> topo_sort_modules() const;
     std::string mangle_module_name(const std::string& module_name) const;
     std::string make_qualified_name(const std::string& module_name, const std::string& name) const;
     std::string module_name_from_qualified_symbol(const std::string& qualified_name) const;
     std::vector<std::string> resolve_function_lookup_names(const std::string& name) const;
+    uint32_t intern_function_name(const std::string& name) const;
+    const std::vector<uint32_t>& lookup_function_name_ids(const std::string& name) const;
     void enter_module_context(const std::string& module_name);
 
     std::string make_function_key(const FunctionNode* node) const;
@@ -141,10 +218,24 @@ private:
         std::filesystem::path path;
         std::string code;
         std::vector<std::string> imports;
+        std::shared_ptr<ParsedModule> parsed;
     };
 
+    void parse_loaded_modules(std::vector<LoadedModule>& modules) const;
+
 private:
+    // The first data member, so interned types outlive every other member that may hold them.
+    TypeContext type_context;
+
     std::unordered_map<std::string, FunctionNode*> functions;
+    // Overloads indexed by interned qualified name, and by (name, arity). Lookups from a module go through the ids its
+    // names resolve to, and resolved call targets are memoized per module until the next function is added.
+    mutable llvm::StringMap<uint32_t> function_name_ids;
+    mutable std::vector<std::vector<FunctionNode*>> overloads_by_name;
+    llvm::DenseMap<std::pair<uint32_t, size_t>, std::vector<FunctionNode*>> overloads_by_arity;
+    mutable std::unordered_map<std::string, std::unordered_map<std::string, std::vector<uint32_t>>> lookup_name_ids;
+    std::unordered_map<std::string, std::map<std::tuple<uint32_t, size_t, CallSignature>, FunctionNode*>>
+        resolved_calls;
     FunctionNode* current_fn_node = nullptr;
     llvm::Function* current_fn = nullptr;
     KType* curr_fn_ret_type = nullptr;
@@ -152,6 +243,8 @@ private:
     std::string code;
     std::string name;
     std::optional<std::filesystem::path> entry_path;
+    CompilerOptions options;
+    std::vector<PassBuilderCallback> pass_callbacks;
     std::filesystem::path current_source_path;
     std::string current_module_name;
     bool building_top_level = false;
@@ -162,16 +255,25 @@ private:
     std::vector<std::unique_ptr<IAnalysisVisitor>> analysis_visitors;
     std::unordered_map<std::string, ClassMetadata> classes_metadata;
 
-    llvm::LLVMContext context {};
+    llvm::orc::ThreadSafeContext ts_context;
+    llvm::LLVMContext& context;
     llvm::IRBuilder<> builder;
     std::unique_ptr<llvm::Module> module;
+    std::unique_ptr<llvm::TargetMachine> target_machine;
+    std::optional<ModuleCache> module_cache;
     llvm::DataLayout data_layout;
+    llvm::DenseMap<llvm::Constant*, llvm::GlobalVariable*> constant_pool;
 
+    // One region per loaded module. Declared after the type context, which arena nodes still release types into
+    // when torn down, and ahead of every other holder of AST nodes.
+    std::unordered_map<std::string, std::unique_ptr<ASTArena>> ast_arenas;
     SymbolTable symbol_table;
     TypeResolver type_resolver {};
 
     std::unordered_map<std::string, TemplateMetadata> template_registry;
     std::vector<ASTNode*> instantiated_nodes;
+    std::vector<SliceIndexFact> slice_index_facts;
+    std::vector<llvm::AllocaInst*> arenas;
 
     std::vector<std::unordered_map<std::string, KType*>> type_alias_scopes;
     std::unordered_map<std::string, std::unordered_map<std::string, std::unique_ptr<KType>>> module_type_aliases;
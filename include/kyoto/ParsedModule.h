@@ -0,0 +1,36 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "ANTLRErrorListener.h"
+#include "ANTLRInputStream.h"
+#include "CommonTokenStream.h"
+#include "KyotoLexer.h"
+#include "KyotoParser.h"
+
+// The parse tree of one source file together with everything it points into. ANTLR trees are owned by the parser
+// that built them and reference its token stream, so the whole pipeline lives and dies with the tree.
+struct ParsedModule {
+    enum class Prediction {
+        // Parse with the cheaper SLL prediction first and only re-parse with full LL if that fails.
+        TwoStage,
+        FullLL,
+    };
+
+    static std::unique_ptr<ParsedModule> parse(const std::string& source,
+                                               Prediction prediction = Prediction::TwoStage);
+
+    // The generated parser keeps its ATN and DFA cache in process-wide static storage shared by every parser instance.
+    // Parsing a sample that touches every rule fills that cache up front, once per process, so parser threads started
+    // afterwards find their predictions cached instead of building them concurrently.
+    static void warm_up();
+
+    std::unique_ptr<antlr4::ANTLRErrorListener> lexer_errors;
+    std::unique_ptr<antlr4::ANTLRErrorListener> parser_errors;
+    std::unique_ptr<antlr4::ANTLRInputStream> input;
+    std::unique_ptr<kyoto::KyotoLexer> lexer;
+    std::unique_ptr<antlr4::CommonTokenStream> tokens;
+    std::unique_ptr<kyoto::KyotoParser> parser;
+    kyoto::KyotoParser::ProgramContext* tree = nullptr;
+};
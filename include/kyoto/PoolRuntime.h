@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+
+class ModuleCompiler;
+
+namespace llvm {
+class Value;
+}
+
+// Size-class pools used for `new` and `free` of class instances under `--alloc=pool`. Blocks are carved out of one
+// lazily malloc'd region and recycled through a free list per 16-byte size class, so neither allocation nor release
+// goes through malloc's bookkeeping. `free` passes the statically known size, and pointers from outside the region
+// (arrays, or allocations made once it is exhausted) are handed back to libc. Kyoto programs are single-threaded, so
+// the pools are plain globals. The runtime is emitted into the module like the arena runtime.
+
+inline constexpr auto* pool_free_function = "__kyoto_pool_free";
+
+// Returns the size of the pooled blocks holding objects of `size` bytes, or 0 when they are too large to be pooled.
+uint64_t get_pool_block_size(uint64_t size);
+
+llvm::Value* gen_pool_alloc(ModuleCompiler& compiler, uint64_t block_size);
+
+void gen_pool_free(ModuleCompiler& compiler, llvm::Value* ptr, uint64_t block_size);
@@ -1,6 +1,11 @@
 #pragma once
 
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
 #include "kyoto/AST/ASTNode.h"
+#include "llvm/Support/Casting.h"
 
 class IAnalysisVisitor {
 public:
@@ -8,18 +13,85 @@ public:
     virtual void visit(ASTNode* node) = 0;
 };
 
+// Calls `visit(NodeToVisit*)` on every NodeToVisit below the root. Unless the derived visitor sets
+// `descends_into_matches`, the walk does not look inside a node it has handed to `visit`. `finish()` runs once the
+// whole tree has been walked, for work that needs every match seen first.
 template <typename Derived, typename NodeToVisit> class AnalysisVisitor : public IAnalysisVisitor {
 public:
-    void visit(ASTNode* node)
+    using Node = NodeToVisit;
+    static constexpr bool descends_into_matches = false;
+
+    void visit(ASTNode* node) override
+    {
+        if (!node) return;
+        walk(node);
+        static_cast<Derived*>(this)->finish();
+    }
+
+    virtual void visit(NodeToVisit* node) = 0;
+    void finish() { }
+
+private:
+    void walk(ASTNode* node)
+    {
+        node->for_each_child([this](ASTNode* child) {
+            if (auto* n = llvm::dyn_cast<NodeToVisit>(child)) {
+                static_cast<Derived*>(this)->visit(n);
+                if (!Derived::descends_into_matches) return;
+            }
+            walk(child);
+        });
+    }
+};
+
+// Runs several AnalysisVisitors in one walk of the tree. Each visitor is handed exactly the nodes it would see walking
+// the tree alone, and the visitors' `finish()` hooks run in order once the walk is over.
+template <typename... Visitors> class FusedAnalysisVisitor : public IAnalysisVisitor {
+    static_assert(sizeof...(Visitors) <= 32);
+
+public:
+    explicit FusedAnalysisVisitor(Visitors... visitors)
+        : visitors(std::move(visitors)...)
+    {
+    }
+
+    void visit(ASTNode* node) override
     {
         if (!node) return;
+        walk(node, all_active);
+        std::apply([](auto&... visitor) { (visitor.finish(), ...); }, visitors);
+    }
+
+    template <size_t I> auto& get() { return std::get<I>(visitors); }
+
+private:
+    static constexpr unsigned all_active = (1ull << sizeof...(Visitors)) - 1;
+
+    // `active` has a bit set for every visitor still looking below `node`.
+    void walk(ASTNode* node, unsigned active)
+    {
+        node->for_each_child([this, active](ASTNode* child) {
+            auto child_active = active;
+            dispatch(child, child_active, std::index_sequence_for<Visitors...> {});
+            if (child_active) walk(child, child_active);
+        });
+    }
 
-        const auto children = node->get_children();
-        for (auto* child : children) {
-            if (auto* n = dynamic_cast<NodeToVisit*>(child); n) static_cast<Derived*>(this)->visit(n);
-            else visit(child);
+    template <size_t... I> void dispatch(ASTNode* node, unsigned& active, std::index_sequence<I...>)
+    {
+        (dispatch_to<I>(node, active), ...);
+    }
+
+    template <size_t I> void dispatch_to(ASTNode* node, unsigned& active)
+    {
+        using Visitor = std::tuple_element_t<I, std::tuple<Visitors...>>;
+        if (!(active & (1u << I))) return;
+
+        if (auto* n = llvm::dyn_cast<typename Visitor::Node>(node)) {
+            std::get<I>(visitors).visit(n);
+            if (!Visitor::descends_into_matches) active &= ~(1u << I);
         }
     }
 
-    virtual void visit(NodeToVisit* node) = 0;
-};
\ No newline at end of file
+    std::tuple<Visitors...> visitors;
+};
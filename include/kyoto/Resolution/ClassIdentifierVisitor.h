@@ -5,6 +5,7 @@
 #include "kyoto/AST/DeclarationNodes.h"
 #include "kyoto/ModuleCompiler.h"
 #include "kyoto/Resolution/AnalysisVisitor.h"
+#include "llvm/Support/Casting.h"
 
 class ClassIdentifierVisitor : public AnalysisVisitor<ClassIdentifierVisitor, ClassDefinitionNode> {
 public:
@@ -16,20 +17,26 @@ public:
     void visit(ClassDefinitionNode* node) override
     {
         auto name = node->get_name();
-        auto children = node->get_children();
+        const auto& children = node->get_components();
+        const auto method_prefix = name + "_";
 
         auto llvm_types = std::vector<llvm::Type*>();
+        ClassMetadata metadata { nullptr, node };
 
         // Conservative estimate. children.size() is methods + fields
         llvm_types.reserve(children.size());
-        for (const auto* child : children) {
-            if (const auto* c = dynamic_cast<const DeclarationStatementNode*>(child); c) {
+        metadata.fields.reserve(children.size());
+        for (auto* child : children) {
+            if (auto* c = llvm::dyn_cast<DeclarationStatementNode>(child)) {
+                metadata.fields.try_emplace(c->get_name(), ClassMetadata::Field { llvm_types.size(), c });
                 llvm_types.push_back(ASTNode::get_llvm_type(c->get_ktype(), compiler));
+            } else if (auto* method = llvm::dyn_cast<FunctionNode>(child); method && !method->is<ConstructorNode>()) {
+                metadata.method_names.insert(method->get_name().substr(method_prefix.size()));
             }
         }
 
-        auto* llvm_struct = llvm::StructType::create(compiler.get_context(), llvm_types, name);
-        compiler.add_class_metadata(name, ClassMetadata { llvm_struct, node });
+        metadata.llvm_type = llvm::StructType::create(compiler.get_context(), llvm_types, name);
+        compiler.add_class_metadata(name, metadata);
     }
 
 private:
@@ -14,15 +14,12 @@ public:
     {
     }
 
+    // Calls nest inside one another's arguments.
+    static constexpr bool descends_into_matches = true;
+
     void visit(FunctionCall* node) override
     {
         if (const auto& name = node->get_name(); compiler.class_exists(name)) node->set_as_constructor_call();
-
-        for (auto* arg : node->get_children()) {
-            auto* f = dynamic_cast<FunctionCall*>(arg);
-            if (f) visit(f);
-            else AnalysisVisitor::visit(arg);
-        }
     }
 
 private:
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include "kyoto/AST/ASTNode.h"
 #include "kyoto/Resolution/AnalysisVisitor.h"
 
@@ -12,8 +14,18 @@ public:
     {
     }
 
-    void visit(FunctionNode* node) override { auto* _ = node->gen_prototype(); }
+    // Prototypes may mention classes declared further down, so they are only generated once every class has been seen.
+    void visit(FunctionNode* node) override { functions.push_back(node); }
+
+    void finish()
+    {
+        for (auto* node : functions) {
+            auto* _ = node->gen_prototype();
+        }
+        functions.clear();
+    }
 
 private:
     ModuleCompiler& compiler;
+    std::vector<FunctionNode*> functions;
 };
\ No newline at end of file
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "llvm/IR/IRBuilder.h"
+
+class ModuleCompiler;
+
+namespace llvm {
+class Function;
+class FunctionType;
+}
+
+// Pieces shared by the runtimes that are emitted into every module (arenas, pools and the runtime checks).
+
+// Creates a private, nounwind function in the module being compiled.
+llvm::Function* declare_runtime_function(ModuleCompiler& compiler, const char* name, llvm::FunctionType* type);
+
+// Returns the cold, noreturn handler that prints `message` and traps, emitting it on first use so that each report
+// sequence appears once per module.
+llvm::Function* get_runtime_error_handler(ModuleCompiler& compiler, const char* name, const char* message);
+
+// Ends the block at `builder`'s insertion point with a call to the handler above, or with a bare trap under
+// `--bounds-checks=trap-only`.
+void gen_runtime_error(ModuleCompiler& compiler, llvm::IRBuilder<>& builder, const char* name, const char* message);
@@ -1,14 +1,17 @@
 #pragma once
 
-#include <map>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 
 #include "kyoto/KType.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
 
 class ModuleCompiler;
+class TypeContext;
 
 namespace llvm {
 class Module;
@@ -20,29 +23,37 @@ struct Symbol {
     llvm::AllocaInst* alloc;
     KType* type;
 
-    static Symbol primitive(llvm::AllocaInst* value, PrimitiveType::Kind kind);
+    static Symbol primitive(llvm::AllocaInst* value, PrimitiveType::Kind kind, TypeContext& types);
     Symbol(llvm::AllocaInst* value, KType* type);
     Symbol() = default;
 };
 
-class Scope {
-    std::map<std::string, Symbol> symbols {};
-
-public:
-    void add_symbol(const std::string& name, const Symbol& symbol);
-    std::optional<Symbol> get_symbol(const std::string& name);
-};
-
+// Names are interned to dense ids, and each id owns the stack of bindings that shadow one another. Lookup, declaration
+// and scope exit therefore cost the same however deeply scopes nest.
 class SymbolTable {
 public:
+    using SymbolId = uint32_t;
+
     SymbolTable();
 
     void push_scope();
     void pop_scope();
+    SymbolId intern(const std::string& name);
     void add_symbol(const std::string& name, Symbol symbol);
-    std::optional<Symbol> get_symbol(const std::string& name);
+    void add_symbol(SymbolId id, Symbol symbol);
+    std::optional<Symbol> get_symbol(const std::string& name) const;
+    std::optional<Symbol> get_symbol(SymbolId id) const;
     size_t n_scopes() const;
 
 private:
-    std::vector<Scope> scopes;
+    struct Binding {
+        Symbol symbol;
+        size_t depth;
+    };
+
+    llvm::StringMap<SymbolId> ids;
+    // Indexed by id; the innermost binding is at the back.
+    std::vector<llvm::SmallVector<Binding, 1>> bindings;
+    // Ids bound in each open scope, so popping one unwinds exactly its bindings.
+    std::vector<std::vector<SymbolId>> scopes;
 };
\ No newline at end of file
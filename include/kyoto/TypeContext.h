@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <map>
+#include <stddef.h>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "kyoto/KType.h"
+
+namespace llvm {
+class Type;
+}
+
+// Owns one canonical, immutable instance of every type it hands out, in the spirit of llvm::LLVMContext. Types
+// obtained here compare by pointer, `copy()` returns them unchanged, and they are all freed when the context dies.
+class TypeContext {
+public:
+    TypeContext() = default;
+    TypeContext(const TypeContext&) = delete;
+    TypeContext& operator=(const TypeContext&) = delete;
+    ~TypeContext();
+
+    PrimitiveType* primitive(PrimitiveType::Kind kind);
+    PointerType* pointer(const KType* pointee);
+    ClassType* class_type(const std::string& name);
+    ArrayType* array(const KType* element_type, size_t n = 0);
+    SliceType* slice(const KType* element_type);
+    VectorType* vector(const KType* element_type, size_t lanes);
+    FunctionType* function(const std::vector<KType*>& param_types, const KType* return_type);
+
+    // Returns the canonical type structurally equal to `type`. `type` itself is neither adopted nor freed.
+    KType* intern(const KType* type);
+
+    [[nodiscard]] llvm::Type* get_llvm_type(const KType* type) const;
+    void cache_llvm_type(const KType* type, llvm::Type* llvm_type);
+
+private:
+    template <typename T> T* adopt(T* type);
+
+    std::vector<KType*> owned;
+    std::array<PrimitiveType*, static_cast<size_t>(PrimitiveType::Kind::Unknown) + 1> primitives {};
+    std::unordered_map<const KType*, PointerType*> pointers;
+    std::unordered_map<std::string, ClassType*> classes;
+    std::map<std::pair<const KType*, size_t>, ArrayType*> arrays;
+    std::unordered_map<const KType*, SliceType*> slices;
+    std::map<std::pair<const KType*, size_t>, VectorType*> vectors;
+    std::map<std::vector<const KType*>, FunctionType*> functions;
+    std::unordered_map<const KType*, llvm::Type*> llvm_types;
+};
@@ -12,6 +12,10 @@ public:
     std::optional<PrimitiveType::Kind> resolve_binary_cmp(PrimitiveType::Kind lhs, PrimitiveType::Kind rhs) const;
     std::optional<PrimitiveType::Kind> resolve_binary_arith(PrimitiveType::Kind lhs, PrimitiveType::Kind rhs) const;
     std::optional<PrimitiveType::Kind> resolve_binary_logical(PrimitiveType::Kind lhs, PrimitiveType::Kind rhs) const;
+    // Both operands must have the same vector type, as scalars are not broadcast implicitly. Comparisons return the
+    // operand type, whose lanes the caller turns into a boolean mask.
+    const VectorType* resolve_vector_arith(const KType* lhs, const KType* rhs) const;
+    const VectorType* resolve_vector_cmp(const KType* lhs, const KType* rhs) const;
     bool promotable_to(PrimitiveType::Kind from, PrimitiveType::Kind to) const;
     bool fits_in(int64_t val, PrimitiveType::Kind kind) const;
 };
\ No newline at end of file
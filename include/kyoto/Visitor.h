@@ -1,16 +1,27 @@
 #pragma once
 
 #include <any>
+#include <string>
+#include <utility>
 
 #include "KyotoParserBaseVisitor.h"
 #include "kyoto/AST/ASTNode.h"
+#include "kyoto/ASTArena.h"
 #include "kyoto/KType.h"
 
 class ModuleCompiler;
 
+// One instantiation of a generic class: the class is built under `name`, and every use of the template parameter
+// `param` as a type resolves to `argument`.
+struct TemplateInstance {
+    std::string name;
+    std::string param;
+    const KType* argument;
+};
+
 class ASTBuilderVisitor final : public kyoto::KyotoParserBaseVisitor {
 public:
-    explicit ASTBuilderVisitor(ModuleCompiler& compiler);
+    explicit ASTBuilderVisitor(ModuleCompiler& compiler, const TemplateInstance* instance = nullptr);
     std::any visitProgram(kyoto::KyotoParser::ProgramContext* ctx) override;
     std::any visitImportStatement(kyoto::KyotoParser::ImportStatementContext* ctx) override;
     std::any visitCdecl(kyoto::KyotoParser::CdeclContext* ctx) override;
@@ -24,6 +35,7 @@ public:
     std::any visitAssignmentExpression(kyoto::KyotoParser::AssignmentExpressionContext* ctx) override;
     std::any visitReturnStatement(kyoto::KyotoParser::ReturnStatementContext* ctx) override;
     std::any visitFreeStatement(kyoto::KyotoParser::FreeStatementContext* ctx) override;
+    std::any visitArenaStatement(kyoto::KyotoParser::ArenaStatementContext* ctx) override;
 
     std::any visitFunctionCallExpression(kyoto::KyotoParser::FunctionCallExpressionContext* ctx) override;
     std::any
@@ -96,6 +108,7 @@ public:
     std::any visitI64Type(kyoto::KyotoParser::I64TypeContext* ctx) override;
     std::any visitF32Type(kyoto::KyotoParser::F32TypeContext* ctx) override;
     std::any visitF64Type(kyoto::KyotoParser::F64TypeContext* ctx) override;
+    std::any visitVectorType(kyoto::KyotoParser::VectorTypeContext* ctx) override;
     std::any visitStrType(kyoto::KyotoParser::StrTypeContext* ctx) override;
     std::any visitVoidType(kyoto::KyotoParser::VoidTypeContext* ctx) override;
     std::any visitPointerType(kyoto::KyotoParser::PointerTypeContext* ctx) override;
@@ -108,10 +121,19 @@ public:
 private:
     [[nodiscard]] std::string visit_module_path(kyoto::KyotoParser::ModulePathContext* ctx) const;
     [[nodiscard]] std::string stringify_type_for_template(const KType* type) const;
+    [[nodiscard]] std::string mangle_template_argument(const KType* type) const;
+    [[nodiscard]] bool is_template_param(const std::string& name) const;
     [[nodiscard]] std::optional<int64_t> parse_signed_integer_into(const std::string& str,
                                                                    PrimitiveType::Kind kind) const;
     [[nodiscard]] std::optional<int64_t> parse_bool(const std::string& str) const;
 
+    template <typename T, typename... Args> T* make(Args&&... args)
+    {
+        return arena.make<T>(std::forward<Args>(args)...);
+    }
+
 private:
     ModuleCompiler& compiler;
+    ASTArena& arena;
+    const TemplateInstance* instance;
 };
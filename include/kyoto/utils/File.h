@@ -18,7 +18,8 @@ public:
     static std::string get_source(std::string_view filename);
     static std::vector<TestCase> get_test_cases(std::string_view filename);
     static int32_t execute_ir(const std::string& ir);
-    static bool compile_ir_to_binary(const std::string& ir, const std::string& output_path);
+    static bool link_executable(const std::vector<std::filesystem::path>& objects, const std::string& output_path);
+    static std::filesystem::path temp_path(const std::string& extension);
     static bool is_executable(const std::string& filename);
 
 private:
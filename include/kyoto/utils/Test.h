@@ -4,7 +4,10 @@
 #include <iostream>
 #include <string>
 
-#define DEFINE_KYOTO_TEST_SUITE(SuiteName, Path)                         \
+#include "kyoto/CompilerOptions.h"
+
+// Runs every case of a `.kyo` file through test_driver, compiled with the CompilerOptions given after the path.
+#define DEFINE_KYOTO_TEST_SUITE_WITH_OPTIONS(SuiteName, Path, ...)       \
     class SuiteName : public ::testing::TestWithParam<utils::TestCase> { \
     protected:                                                           \
         utils::TestCase test_case;                                       \
@@ -15,15 +18,17 @@
     };                                                                   \
     TEST_P(SuiteName, SuiteName)                                         \
     {                                                                    \
-        utils::test_driver(test_case);                                   \
+        utils::test_driver(test_case, __VA_ARGS__);                      \
     }                                                                    \
                                                                          \
-    static auto generate_test_cases()                                    \
+    static auto generate_##SuiteName##_test_cases()                      \
     {                                                                    \
         const auto test_cases = utils::File::get_test_cases(Path);       \
         return test_cases;                                               \
     }                                                                    \
-    INSTANTIATE_TEST_SUITE_P(SuiteName, SuiteName, testing::ValuesIn(generate_test_cases()));
+    INSTANTIATE_TEST_SUITE_P(SuiteName, SuiteName, testing::ValuesIn(generate_##SuiteName##_test_cases()));
+
+#define DEFINE_KYOTO_TEST_SUITE(SuiteName, Path) DEFINE_KYOTO_TEST_SUITE_WITH_OPTIONS(SuiteName, Path, CompilerOptions {})
 
 namespace utils {
 
@@ -69,6 +74,12 @@ private:
     std::filesystem::path source_file {};
 };
 
-void test_driver(const TestCase& test_case);
+void test_driver(const TestCase& test_case, const CompilerOptions& options = {});
+
+// Compiles `code` as a standalone module, expecting success, and returns its IR (empty on failure).
+std::string compile_ir(const std::string& code, const CompilerOptions& options = {});
+
+// Compiles `code` as a standalone module, expecting failure, and returns what the compiler reported on stderr.
+std::string compile_error(const std::string& code, const CompilerOptions& options = {});
 
 }
@@ -1,10 +1,14 @@
+#include <algorithm>
 #include <boost/program_options.hpp>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <optional>
+#include <sstream>
 #include <string>
 #include <vector>
 
+#include "kyoto/ModuleCache.h"
 #include "kyoto/ModuleCompiler.h"
 #include "kyoto/utils/File.h"
 #include "support/Declarations.h"
@@ -18,11 +22,89 @@ void print_usage(const std::string& prog, const po::options_description& desc)
     std::cout << desc << std::endl;
 }
 
+std::optional<std::vector<ModuleCompiler::EmitKind>> parse_emit_kinds(const std::string& value)
+{
+    std::vector<ModuleCompiler::EmitKind> kinds;
+    std::istringstream iss(value);
+    std::string kind;
+    while (std::getline(iss, kind, ',')) {
+        if (kind == "obj") kinds.push_back(ModuleCompiler::EmitKind::Object);
+        else if (kind == "asm") kinds.push_back(ModuleCompiler::EmitKind::Assembly);
+        else if (kind == "bc") kinds.push_back(ModuleCompiler::EmitKind::Bitcode);
+        else if (kind == "ll") kinds.push_back(ModuleCompiler::EmitKind::IR);
+        else {
+            std::cerr << "Error: Unknown emit kind `" << kind << "` (expected obj, asm, bc or ll)" << std::endl;
+            return std::nullopt;
+        }
+    }
+
+    // Codegen lowers the module in place, so textual IR and bitcode go first.
+    std::ranges::sort(kinds);
+    kinds.erase(std::unique(kinds.begin(), kinds.end()), kinds.end());
+    return kinds;
+}
+
+std::optional<OptLevel> parse_opt_level(const std::string& value)
+{
+    if (value == "0") return OptLevel::O0;
+    if (value == "1") return OptLevel::O1;
+    if (value == "2") return OptLevel::O2;
+    if (value == "3") return OptLevel::O3;
+    if (value == "s") return OptLevel::Os;
+
+    std::cerr << "Error: Unknown optimization level `" << value << "` (expected 0, 1, 2, 3 or s)" << std::endl;
+    return std::nullopt;
+}
+
+std::optional<BoundsCheckMode> parse_bounds_check_mode(const std::string& value)
+{
+    if (value == "on") return BoundsCheckMode::On;
+    if (value == "off") return BoundsCheckMode::Off;
+    if (value == "trap-only") return BoundsCheckMode::TrapOnly;
+
+    std::cerr << "Error: Unknown bounds check mode `" << value << "` (expected on, off or trap-only)" << std::endl;
+    return std::nullopt;
+}
+
+std::optional<AllocMode> parse_alloc_mode(const std::string& value)
+{
+    if (value == "malloc") return AllocMode::Malloc;
+    if (value == "pool") return AllocMode::Pool;
+
+    std::cerr << "Error: Unknown allocator `" << value << "` (expected malloc or pool)" << std::endl;
+    return std::nullopt;
+}
+
+std::string emit_extension(ModuleCompiler::EmitKind kind)
+{
+    switch (kind) {
+    case ModuleCompiler::EmitKind::IR:
+        return ".ll";
+    case ModuleCompiler::EmitKind::Bitcode:
+        return ".bc";
+    case ModuleCompiler::EmitKind::Assembly:
+        return ".s";
+    case ModuleCompiler::EmitKind::Object:
+        return ".o";
+    }
+    return "";
+}
+
 int run(int argc, const char* argv[])
 {
     po::options_description desc("The Kyoto Programming Language Compiler");
-    desc.add_options()("help,h", "Print this help message")("run,r", "Run the program in `lli` after compilation")(
-        "output,o", po::value<std::string>()->default_value("a.out"), "Output file for the executable binary");
+    desc.add_options()("help,h", "Print this help message")("run,r", "JIT-compile and run the program in-process")(
+        "output,o", po::value<std::string>()->default_value("a.out"), "Output file for the executable binary")(
+        "compile,c", "Compile to an object file without linking")(
+        "opt-level,O", po::value<std::string>(), "Optimization level (0, 1, 2, 3 or s; 2 by default, 0 with --run)")(
+        "bounds-checks", po::value<std::string>()->default_value("on"),
+        "Slice and vector lane checks (on, off or trap-only)")(
+        "alloc", po::value<std::string>()->default_value("malloc"), "Allocator for class instances (malloc or pool)")(
+        "jobs,j", po::value<unsigned>()->default_value(0), "Threads used to parse modules (0 uses all cores)")(
+        "cache", "Reuse optimized bitcode of unchanged imported modules")(
+        "cache-dir", po::value<std::string>(), "Directory for the module cache (implies --cache)")(
+        "emit", po::value<std::string>(), "Comma-separated list of outputs to emit instead of linking (obj,asm,bc,ll)")(
+        "opt-remarks", "Report the optimizations applied by the compiler");
 
     po::positional_options_description pos;
     pos.add("files", -1);
@@ -56,19 +138,63 @@ int run(int argc, const char* argv[])
     }
 
     const auto& file = files[0];
-    auto source = utils::File::get_source(file);
-    ModuleCompiler compiler(source, "main", file);
+    // Built programs are optimized like they were when they went through `clang -O2`, while --run favors a fast start.
+    std::optional<OptLevel> opt_level = vm.contains("run") ? OptLevel::O0 : OptLevel::O2;
+    if (vm.contains("opt-level")) opt_level = parse_opt_level(vm["opt-level"].as<std::string>());
+    if (!opt_level) return 1;
+    auto bounds_checks = parse_bounds_check_mode(vm["bounds-checks"].as<std::string>());
+    if (!bounds_checks) return 1;
+    auto alloc = parse_alloc_mode(vm["alloc"].as<std::string>());
+    if (!alloc) return 1;
+
+    CompilerOptions options;
+    options.opt_level = *opt_level;
+    options.bounds_checks = *bounds_checks;
+    options.alloc = *alloc;
+    options.jobs = vm["jobs"].as<unsigned>();
+    options.opt_remarks = vm.contains("opt-remarks");
+    if (vm.contains("cache-dir")) {
+        options.cache_dir = vm["cache-dir"].as<std::string>();
+    } else if (vm.contains("cache")) {
+        options.cache_dir = ModuleCache::default_directory();
+    }
 
-    auto output = vm["output"].as<std::string>();
-    auto ir = compiler.gen_ir();
+    auto source = utils::File::get_source(file);
+    ModuleCompiler compiler(source, "main", file, options);
 
-    if (!ir) return 1;
+    if (!compiler.gen_module()) return 1;
 
     if (vm.contains("run")) {
-        return utils::File::execute_ir(*ir);
+        return compiler.run_jit().value_or(1);
     }
 
-    if (!utils::File::compile_ir_to_binary(*ir, output)) {
+    std::vector<ModuleCompiler::EmitKind> emit_kinds;
+    if (vm.contains("emit")) {
+        auto kinds = parse_emit_kinds(vm["emit"].as<std::string>());
+        if (!kinds) return 1;
+        emit_kinds = std::move(*kinds);
+    } else if (vm.contains("compile")) {
+        emit_kinds.push_back(ModuleCompiler::EmitKind::Object);
+    }
+
+    const auto output = vm["output"].as<std::string>();
+
+    if (!emit_kinds.empty()) {
+        const bool explicit_output = !vm["output"].defaulted();
+        for (auto kind : emit_kinds) {
+            auto path = explicit_output ? std::filesystem::path(output) : std::filesystem::path(file).filename();
+            if (!explicit_output || emit_kinds.size() > 1) path.replace_extension(emit_extension(kind));
+            if (!compiler.emit(kind, path)) return 1;
+        }
+        return 0;
+    }
+
+    const auto object = utils::File::temp_path(".o");
+    const bool linked = compiler.emit(ModuleCompiler::EmitKind::Object, object)
+        && utils::File::link_executable({ object }, output);
+    std::filesystem::remove(object);
+
+    if (!linked) {
         std::cerr << "Error: Failed to compile to binary" << std::endl;
         return 1;
     }
@@ -1,6 +1,7 @@
 #include <cassert>
 #include <format>
 #include <llvm/IR/Module.h>
+#include <new>
 #include <stddef.h>
 #include <stdexcept>
 #include <string>
@@ -18,7 +19,22 @@
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/Type.h"
 
-llvm::Type* ASTNode::get_llvm_type(const KType* type, ModuleCompiler& compiler)
+void ASTNode::operator delete(ASTNode* node, std::destroying_delete_t)
+{
+    if (node->arena_allocated) return;
+    node->~ASTNode();
+    ::operator delete(node);
+}
+
+std::vector<ASTNode*> ASTNode::get_children() const
+{
+    std::vector<ASTNode*> children;
+    for_each_child([&children](ASTNode* child) { children.push_back(child); });
+    return children;
+}
+
+namespace {
+llvm::Type* get_uncached_llvm_type(const KType* type, ModuleCompiler& compiler)
 {
     auto& context = compiler.get_context();
     if (type->is_pointer() || type->is_function()) {
@@ -31,20 +47,27 @@ llvm::Type* ASTNode::get_llvm_type(const KType* type, ModuleCompiler& compiler)
 
     if (type->is_array()) {
         const auto* array_type = type->as<ArrayType>();
-        return llvm::ArrayType::get(get_llvm_type(array_type->get_element_type(), compiler), array_type->get_size());
+        return llvm::ArrayType::get(ASTNode::get_llvm_type(array_type->get_element_type(), compiler),
+                                    array_type->get_size());
     }
 
     if (type->is_slice()) {
         return llvm::StructType::get(context, { llvm::PointerType::get(context, 0), llvm::Type::getInt64Ty(context) });
     }
 
+    if (type->is_vector()) {
+        const auto* vector_type = type->as<VectorType>();
+        return llvm::FixedVectorType::get(ASTNode::get_llvm_type(vector_type->get_element_type(), compiler),
+                                          vector_type->get_lanes());
+    }
+
     if (!type->is_primitive()) {
-        if (!dynamic_cast<const PointerType*>(type)) {
+        if (!type->is<PointerType>()) {
             throw std::runtime_error(std::format("Unsupported type `{}`", type->to_string()));
         }
     }
 
-    const auto primitive_type = dynamic_cast<const PrimitiveType*>(type);
+    const auto primitive_type = type->as<PrimitiveType>();
     switch (primitive_type->get_kind()) {
     case PrimitiveType::Kind::Boolean:
         return llvm::Type::getInt1Ty(context);
@@ -70,9 +93,22 @@ llvm::Type* ASTNode::get_llvm_type(const KType* type, ModuleCompiler& compiler)
     }
     return nullptr;
 }
+}
+
+llvm::Type* ASTNode::get_llvm_type(const KType* type, ModuleCompiler& compiler)
+{
+    if (!type->is_interned()) return get_uncached_llvm_type(type, compiler);
+
+    auto& types = compiler.get_type_context();
+    if (auto* cached = types.get_llvm_type(type)) return cached;
+    auto* llvm_type = get_uncached_llvm_type(type, compiler);
+    if (llvm_type) types.cache_llvm_type(type, llvm_type);
+    return llvm_type;
+}
 
 ProgramNode::ProgramNode(std::vector<ASTNode*> nodes, ModuleCompiler& compiler)
-    : nodes(std::move(nodes))
+    : ASTNode(Kind::ProgramNode)
+    , nodes(std::move(nodes))
     , compiler(compiler)
 {
 }
@@ -105,7 +141,8 @@ llvm::Value* ProgramNode::gen()
 }
 
 ExpressionStatementNode::ExpressionStatementNode(ExpressionNode* expr, ModuleCompiler& compiler)
-    : expr(expr)
+    : ASTNode(Kind::ExpressionStatementNode)
+    , expr(expr)
 {
 }
 
@@ -124,13 +161,14 @@ llvm::Value* ExpressionStatementNode::gen()
     return expr->gen();
 }
 
-std::vector<ASTNode*> ExpressionStatementNode::get_children() const
+void ExpressionStatementNode::for_each_child(ChildCallback fn) const
 {
-    return { expr };
+    fn(expr);
 }
 
 BlockNode::BlockNode(std::vector<ASTNode*> nodes, ModuleCompiler& compiler)
-    : nodes(std::move(nodes))
+    : ASTNode(Kind::BlockNode)
+    , nodes(std::move(nodes))
     , compiler(compiler)
 {
 }
@@ -170,7 +208,15 @@ llvm::Value* BlockNode::gen()
 
 FunctionNode::FunctionNode(std::string name, std::vector<Parameter> args, bool varargs, KType* ret_type, ASTNode* body,
                            ModuleCompiler& compiler, bool is_external, std::string linkage_name)
-    : name(std::move(name))
+    : FunctionNode(Kind::FunctionNode, std::move(name), std::move(args), varargs, ret_type, body, compiler, is_external,
+                   std::move(linkage_name))
+{
+}
+
+FunctionNode::FunctionNode(Kind kind, std::string name, std::vector<Parameter> args, bool varargs, KType* ret_type,
+                           ASTNode* body, ModuleCompiler& compiler, bool is_external, std::string linkage_name)
+    : ASTNode(kind)
+    , name(std::move(name))
     , args(std::move(args))
     , varargs(varargs)
     , ret_type(ret_type)
@@ -221,8 +267,8 @@ llvm::Function* FunctionNode::gen_prototype()
     auto* return_ltype = get_llvm_type(ret_type, compiler);
     auto* func_type = llvm::FunctionType::get(return_ltype, get_arg_types(), varargs);
 
-    return llvm::Function::Create(func_type, llvm::Function::ExternalLinkage, compiler.get_function_llvm_name(this),
-                                  compiler.get_module());
+    const auto linkage = template_instance ? llvm::Function::LinkOnceODRLinkage : llvm::Function::ExternalLinkage;
+    return llvm::Function::Create(func_type, linkage, compiler.get_function_llvm_name(this), compiler.get_module());
 }
 
 std::vector<llvm::Type*> FunctionNode::get_arg_types() const
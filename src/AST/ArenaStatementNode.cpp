@@ -0,0 +1,48 @@
+#include "kyoto/AST/ArenaStatementNode.h"
+
+#include <format>
+
+#include "kyoto/ArenaRuntime.h"
+#include "kyoto/ModuleCompiler.h"
+#include "llvm/IR/BasicBlock.h"
+#include "llvm/IR/IRBuilder.h"
+
+ArenaStatementNode::ArenaStatementNode(ASTNode* body, ModuleCompiler& compiler)
+    : ASTNode(Kind::ArenaStatementNode)
+    , body(body)
+    , compiler(compiler)
+{
+}
+
+ArenaStatementNode::~ArenaStatementNode()
+{
+    delete body;
+}
+
+std::string ArenaStatementNode::to_string() const
+{
+    return std::format("Arena({})", body->to_string());
+}
+
+llvm::Value* ArenaStatementNode::gen()
+{
+    auto* arena = create_arena(compiler);
+
+    compiler.push_arena(arena);
+    try {
+        body->gen();
+    } catch (...) {
+        compiler.pop_arena();
+        throw;
+    }
+    compiler.pop_arena();
+
+    // Paths that return from inside the block have already released the arena.
+    if (!compiler.get_builder().GetInsertBlock()->getTerminator()) gen_arena_release(compiler, arena);
+    return nullptr;
+}
+
+void ArenaStatementNode::for_each_child(ChildCallback fn) const
+{
+    fn(body);
+}
@@ -7,13 +7,13 @@
 #include <string.h>
 #include <utility>
 
-#include "kyoto/AST/DeclarationNodes.h"
 #include "kyoto/KType.h"
 #include "kyoto/ModuleCompiler.h"
 
 ClassDefinitionNode::ClassDefinitionNode(std::string name, std::string parent, std::vector<ASTNode*> components,
                                          ModuleCompiler& compiler)
-    : name(std::move(name))
+    : ASTNode(Kind::ClassDefinitionNode)
+    , name(std::move(name))
     , parent(std::move(parent))
     , components(std::move(components))
     , compiler(compiler)
@@ -50,20 +50,9 @@ llvm::Value* ClassDefinitionNode::gen()
     return nullptr;
 }
 
-const ASTNode* ClassDefinitionNode::get_declaration_of(const std::string& name) const
-{
-    for (const auto& component : components) {
-        if (component->is<DeclarationStatementNode>()
-            && component->as<DeclarationStatementNode>()->get_name() == name) {
-            return component;
-        }
-    }
-    return nullptr;
-}
-
 ConstructorNode::ConstructorNode(std::string name, std::vector<FunctionNode::Parameter> args, ASTNode* body,
                                  ModuleCompiler& compiler)
-    : FunctionNode(std::move(name), std::move(args), false, KType::get_void(), body, compiler)
+    : FunctionNode(Kind::ConstructorNode, std::move(name), std::move(args), false, KType::get_void(), body, compiler)
 {
     compiler.add_function(this);
 }
@@ -4,6 +4,7 @@
 #include <format>
 #include <stdexcept>
 
+#include "kyoto/AST/Expressions/ArrayNode.h"
 #include "kyoto/AST/Expressions/ExpressionNode.h"
 #include "kyoto/AST/Expressions/FunctionCallNode.h"
 #include "kyoto/KType.h"
@@ -15,9 +16,11 @@
 #include "llvm/IR/Instructions.h"
 
 DeclarationStatementNode::DeclarationStatementNode(std::string name, KType* ktype, ModuleCompiler& compiler)
-    : name(name)
+    : ASTNode(Kind::DeclarationStatementNode)
+    , name(name)
     , type(ktype)
     , compiler(compiler)
+    , symbol_id(compiler.intern_symbol(this->name))
 {
 }
 
@@ -34,18 +37,20 @@ std::string DeclarationStatementNode::to_string() const
 llvm::Value* DeclarationStatementNode::gen()
 {
     auto* ltype = get_llvm_type(type, compiler);
-    auto* val = new llvm::AllocaInst(ltype, 0, name, compiler.get_builder().GetInsertBlock());
+    auto* val = compiler.create_entry_block_alloca(ltype, name);
 
-    compiler.add_symbol(name, Symbol { val, type });
+    compiler.add_symbol(symbol_id, Symbol { val, type });
     return val;
 }
 
 FullDeclarationStatementNode::FullDeclarationStatementNode(std::string name, KType* ktype, ExpressionNode* expr,
                                                            ModuleCompiler& compiler)
-    : name(name)
+    : ASTNode(Kind::FullDeclarationStatementNode)
+    , name(name)
     , type(ktype)
     , expr(expr)
     , compiler(compiler)
+    , symbol_id(compiler.intern_symbol(this->name))
 {
 }
 
@@ -98,7 +103,7 @@ void FullDeclarationStatementNode::validate_expression_not_void() const
 llvm::AllocaInst* FullDeclarationStatementNode::create_alloca() const
 {
     auto* ltype = get_llvm_type(type, compiler);
-    return new llvm::AllocaInst(ltype, 0, name, compiler.get_builder().GetInsertBlock());
+    return compiler.create_entry_block_alloca(ltype, name);
 }
 
 llvm::Value* FullDeclarationStatementNode::generate_expression_value(llvm::AllocaInst* alloca)
@@ -124,6 +129,10 @@ llvm::Value* FullDeclarationStatementNode::generate_expression_value(llvm::Alloc
     }
 
     if (type->is_array() && expr_ktype->is_array() && type->operator==(*expr_ktype)) {
+        if (is_initializing_array_literal()) {
+            expr->as<ArrayNode>()->gen_into(alloca);
+            return alloca;
+        }
         return expr->gen();
     }
 
@@ -131,6 +140,10 @@ llvm::Value* FullDeclarationStatementNode::generate_expression_value(llvm::Alloc
         return expr->gen();
     }
 
+    if (type->is_vector() && expr_ktype->is_vector() && type->operator==(*expr_ktype)) {
+        return expr->gen();
+    }
+
     if (ExpressionNode::can_convert_array_to_slice(type, expr_ktype)) {
         return ExpressionNode::convert_array_to_slice(expr, type, compiler);
     }
@@ -154,9 +167,14 @@ bool FullDeclarationStatementNode::is_assigning_to_class_instance() const
     return type->is_class() && expr->is<FunctionCall>() && expr->as<FunctionCall>()->is_constructor_call();
 }
 
+bool FullDeclarationStatementNode::is_initializing_array_literal() const
+{
+    return type->is_array() && expr->is<ArrayNode>();
+}
+
 llvm::Value* FullDeclarationStatementNode::handle_constructor_call(llvm::AllocaInst* alloca) const
 {
-    compiler.add_symbol(name, Symbol { alloca, type });
+    compiler.add_symbol(symbol_id, Symbol { alloca, type });
     auto* f = expr->as<FunctionCall>();
     f->set_destination(alloca);
     auto _ = f->gen();
@@ -166,11 +184,11 @@ llvm::Value* FullDeclarationStatementNode::handle_constructor_call(llvm::AllocaI
 void FullDeclarationStatementNode::store_val_and_register_symbol(llvm::Value* expr_val, llvm::AllocaInst* alloca) const
 {
     if (is_assigning_to_class_instance()) return;
-    compiler.get_builder().CreateStore(expr_val, alloca);
-    compiler.add_symbol(name, Symbol { alloca, type });
+    if (!is_initializing_array_literal()) compiler.get_builder().CreateStore(expr_val, alloca);
+    compiler.add_symbol(symbol_id, Symbol { alloca, type });
 }
 
-std::vector<ASTNode*> FullDeclarationStatementNode::get_children() const
+void FullDeclarationStatementNode::for_each_child(ChildCallback fn) const
 {
-    return { expr };
+    fn(expr);
 }
@@ -10,7 +10,8 @@
 #include "llvm/IR/Module.h"
 
 AnonymousFunctionNode::AnonymousFunctionNode(FunctionNode* function, FunctionType* type, ModuleCompiler& compiler)
-    : function(function)
+    : ExpressionNode(Kind::AnonymousFunctionNode)
+    , function(function)
     , type(type)
     , compiler(compiler)
 {
@@ -45,7 +46,4 @@ KType* AnonymousFunctionNode::get_ktype() const
     return type;
 }
 
-std::vector<ASTNode*> AnonymousFunctionNode::get_children() const
-{
-    return {};
-}
+void AnonymousFunctionNode::for_each_child(ChildCallback) const { }
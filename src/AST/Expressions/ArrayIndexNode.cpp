@@ -7,19 +7,23 @@
 #include <llvm/IR/DerivedTypes.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/Instructions.h>
-#include <llvm/IR/Intrinsics.h>
-#include <llvm/IR/Module.h>
 #include <stdexcept>
 #include <vector>
 
 #include "kyoto/AST/ASTNode.h"
+#include "kyoto/AST/Expressions/IdentifierNode.h"
+#include "kyoto/AST/Expressions/NumberNode.h"
+#include "kyoto/Analysis/BoundsCheckElimination.h"
+#include "kyoto/CompilerOptions.h"
 #include "kyoto/KType.h"
 #include "kyoto/ModuleCompiler.h"
+#include "kyoto/RuntimeSupport.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/Type.h"
 
 ArrayIndexNode::ArrayIndexNode(ExpressionNode* array, ExpressionNode* index, ModuleCompiler& compiler)
-    : array(array)
+    : ExpressionNode(Kind::ArrayIndexNode)
+    , array(array)
     , index(index)
     , compiler(compiler)
 {
@@ -29,7 +33,6 @@ ArrayIndexNode::~ArrayIndexNode()
 {
     delete array;
     delete index;
-    delete cached_type;
 }
 
 std::string ArrayIndexNode::to_string() const
@@ -49,6 +52,9 @@ llvm::Value* ArrayIndexNode::gen()
         return gen_pointer_access();
     } else if (array_ktype->is_slice()) {
         return gen_slice_access();
+    } else if (array_ktype->is_vector()) {
+        auto* vector_value = array->gen();
+        return compiler.get_builder().CreateExtractElement(vector_value, gen_lane_index(), "lane");
     } else {
         throw std::runtime_error(std::format("Cannot index into type '{}'", array_ktype->to_string()));
     }
@@ -75,11 +81,43 @@ llvm::Value* ArrayIndexNode::gen_ptr() const
         return compiler.get_builder().CreateGEP(gen_type(), array_val, index_val, "arrayptr");
     } else if (array_ktype->is_slice()) {
         return gen_slice_element_ptr();
+    } else if (array_ktype->is_vector()) {
+        // Lanes of non-mask vectors are laid out like array elements, so a lane is addressed as one.
+        if (array_ktype->as<VectorType>()->get_element_type()->is_boolean()) {
+            throw std::runtime_error(std::format("Cannot take the address of a lane of mask `{}`", array->to_string()));
+        }
+        auto* vector_ptr = array->gen_ptr();
+        if (!vector_ptr) {
+            throw std::runtime_error("Cannot get pointer to vector");
+        }
+        return compiler.get_builder().CreateGEP(gen_type(), vector_ptr, gen_lane_index(), "laneptr");
     } else {
         throw std::runtime_error(std::format("Cannot get pointer to element of type '{}'", array_ktype->to_string()));
     }
 }
 
+bool ArrayIndexNode::is_mask_lane() const
+{
+    const auto* vector = array->get_ktype()->as<VectorType>();
+    return vector && vector->get_element_type()->is_boolean();
+}
+
+// Mask lanes are not addressable, so a write replaces the lane in the whole mask and stores the mask back.
+void ArrayIndexNode::gen_mask_lane_store(llvm::Value* value) const
+{
+    const_cast<ArrayIndexNode*>(this)->validate_index_type();
+
+    auto* vector_ptr = array->gen_ptr();
+    if (!vector_ptr) {
+        throw std::runtime_error("Cannot get pointer to vector");
+    }
+
+    auto& builder = compiler.get_builder();
+    auto* vector_value = builder.CreateLoad(array->gen_type(), vector_ptr, "mask");
+    auto* updated = builder.CreateInsertElement(vector_value, value, gen_lane_index(), "mask.lane");
+    builder.CreateStore(updated, vector_ptr);
+}
+
 llvm::Type* ArrayIndexNode::gen_type() const
 {
     auto* result_ktype = get_ktype();
@@ -106,9 +144,10 @@ bool ArrayIndexNode::is_trivially_evaluable() const
     return false;
 }
 
-std::vector<ASTNode*> ArrayIndexNode::get_children() const
+void ArrayIndexNode::for_each_child(ChildCallback fn) const
 {
-    return { array, index };
+    fn(array);
+    fn(index);
 }
 
 llvm::Value* ArrayIndexNode::gen_array_access() const
@@ -131,42 +170,82 @@ llvm::Value* ArrayIndexNode::gen_slice_access() const
 
 llvm::Value* ArrayIndexNode::gen_slice_element_ptr() const
 {
+    auto& builder = compiler.get_builder();
     auto* slice_value = array->gen();
-    auto* data_ptr = compiler.get_builder().CreateExtractValue(slice_value, { 0 }, "slice.data");
-    auto* size_value = compiler.get_builder().CreateExtractValue(slice_value, { 1 }, "slice.size");
+    auto* data_ptr = builder.CreateExtractValue(slice_value, { 0 }, "slice.data");
     auto* raw_index = index->gen();
     auto* i64_type = llvm::Type::getInt64Ty(compiler.get_context());
     auto* index_value = raw_index->getType()->isIntegerTy(64)
         ? raw_index
-        : compiler.get_builder().CreateIntCast(raw_index, i64_type, true, "slice.index");
+        : builder.CreateIntCast(raw_index, i64_type, true, "slice.index");
+
+    auto mode = compiler.get_options().bounds_checks;
+    const auto* fact = find_slice_index_fact();
+    if (mode == BoundsCheckMode::Off || (fact && fact->non_negative)) {
+        return builder.CreateGEP(gen_type(), data_ptr, index_value, "sliceptr");
+    }
 
     auto* zero = llvm::ConstantInt::get(i64_type, 0, true);
-    auto* non_negative = compiler.get_builder().CreateICmpSGE(index_value, zero, "slice.index.nonnegative");
-    auto* below_size = compiler.get_builder().CreateICmpSLT(index_value, size_value, "slice.index.inrange");
-    auto* in_bounds = compiler.get_builder().CreateAnd(non_negative, below_size, "slice.index.ok");
+    llvm::Value* in_bounds = builder.CreateICmpSGE(index_value, zero, "slice.index.nonnegative");
+    if (!fact) {
+        auto* size_value = builder.CreateExtractValue(slice_value, { 1 }, "slice.size");
+        auto* below_size = builder.CreateICmpSLT(index_value, size_value, "slice.index.inrange");
+        in_bounds = builder.CreateAnd(in_bounds, below_size, "slice.index.ok");
+    }
 
-    auto* fn = compiler.get_builder().GetInsertBlock()->getParent();
+    auto* fn = builder.GetInsertBlock()->getParent();
     auto* trap_bb = llvm::BasicBlock::Create(compiler.get_context(), "slice_oob", fn);
     auto* ok_bb = llvm::BasicBlock::Create(compiler.get_context(), "slice_inbounds", fn);
 
-    compiler.get_builder().CreateCondBr(in_bounds, ok_bb, trap_bb);
+    builder.CreateCondBr(in_bounds, ok_bb, trap_bb);
+
+    builder.SetInsertPoint(trap_bb);
+    gen_runtime_error(compiler, builder, "__kyoto_slice_oob", "runtime error: slice index out of bounds");
+
+    builder.SetInsertPoint(ok_bb);
+    return builder.CreateGEP(gen_type(), data_ptr, index_value, "sliceptr");
+}
+
+const SliceIndexFact* ArrayIndexNode::find_slice_index_fact() const
+{
+    auto* slice_id = array->as<IdentifierExpressionNode>();
+    auto* index_id = index->as<IdentifierExpressionNode>();
+    if (!slice_id || !index_id) return nullptr;
+
+    auto slice_symbol = compiler.get_symbol(slice_id->get_symbol_id());
+    auto index_symbol = compiler.get_symbol(index_id->get_symbol_id());
+    if (!slice_symbol || !index_symbol) return nullptr;
+
+    return compiler.find_slice_index_fact(index_symbol->alloc, slice_symbol->alloc);
+}
+
+// Constant lane indices are checked at compile time. Dynamic ones are checked at run time like slice indices, unless
+// bounds checks are off.
+llvm::Value* ArrayIndexNode::gen_lane_index() const
+{
+    const auto lanes = array->get_ktype()->as<VectorType>()->get_lanes();
+    const auto* number = index->as<NumberNode>();
+    if (number && (number->get_value() < 0 || static_cast<size_t>(number->get_value()) >= lanes)) {
+        throw std::runtime_error(std::format("Lane index {} is out of range for `{}` of type `{}`", number->get_value(),
+                                             array->to_string(), array->get_ktype()->to_string()));
+    }
+
+    auto& builder = compiler.get_builder();
+    auto* index_value = builder.CreateIntCast(index->gen(), builder.getInt64Ty(), true, "lane.index");
+    if (number || compiler.get_options().bounds_checks == BoundsCheckMode::Off) return index_value;
+
+    // A negative index compares as a huge unsigned one, so one comparison covers both ends.
+    auto* in_range = builder.CreateICmpULT(index_value, builder.getInt64(lanes), "lane.index.inrange");
+    auto* fn = builder.GetInsertBlock()->getParent();
+    auto* trap_bb = llvm::BasicBlock::Create(compiler.get_context(), "lane_oob", fn);
+    auto* ok_bb = llvm::BasicBlock::Create(compiler.get_context(), "lane_inbounds", fn);
+    builder.CreateCondBr(in_range, ok_bb, trap_bb);
 
-    compiler.get_builder().SetInsertPoint(trap_bb);
-    auto* puts_type = llvm::FunctionType::get(llvm::Type::getInt32Ty(compiler.get_context()),
-                                              { llvm::PointerType::get(compiler.get_context(), 0) }, false);
-    auto puts_fn = compiler.get_module()->getOrInsertFunction("puts", puts_type);
-    auto* message = compiler.get_builder().CreateGlobalString("runtime error: slice index out of bounds");
-    compiler.get_builder().CreateCall(puts_fn, { message });
-    auto* ptr_type = llvm::PointerType::get(compiler.get_context(), 0);
-    auto* fflush_type = llvm::FunctionType::get(llvm::Type::getInt32Ty(compiler.get_context()), { ptr_type }, false);
-    auto fflush_fn = compiler.get_module()->getOrInsertFunction("fflush", fflush_type);
-    compiler.get_builder().CreateCall(fflush_fn, { llvm::ConstantPointerNull::get(ptr_type) });
-    auto trap_fn = llvm::Intrinsic::getOrInsertDeclaration(compiler.get_module(), llvm::Intrinsic::trap);
-    compiler.get_builder().CreateCall(trap_fn);
-    compiler.get_builder().CreateUnreachable();
+    builder.SetInsertPoint(trap_bb);
+    gen_runtime_error(compiler, builder, "__kyoto_vector_lane_oob", "runtime error: vector lane index out of bounds");
 
-    compiler.get_builder().SetInsertPoint(ok_bb);
-    return compiler.get_builder().CreateGEP(gen_type(), data_ptr, index_value, "sliceptr");
+    builder.SetInsertPoint(ok_bb);
+    return index_value;
 }
 
 void ArrayIndexNode::validate_index_type() const
@@ -180,13 +259,16 @@ void ArrayIndexNode::validate_index_type() const
 KType* ArrayIndexNode::calculate_result_type() const
 {
     auto* array_ktype = array->get_ktype();
+    auto& types = compiler.get_type_context();
 
     if (array_ktype->is_array()) {
-        return array_ktype->as<ArrayType>()->get_element_type()->copy();
+        return types.intern(array_ktype->as<ArrayType>()->get_element_type());
     } else if (array_ktype->is_pointer()) {
-        return array_ktype->as<PointerType>()->get_pointee()->copy();
+        return types.intern(array_ktype->as<PointerType>()->get_pointee());
     } else if (array_ktype->is_slice()) {
-        return array_ktype->as<SliceType>()->get_element_type()->copy();
+        return types.intern(array_ktype->as<SliceType>()->get_element_type());
+    } else if (array_ktype->is_vector()) {
+        return types.intern(array_ktype->as<VectorType>()->get_element_type());
     } else {
         throw std::runtime_error(std::format("Cannot index into type '{}'", array_ktype->to_string()));
     }
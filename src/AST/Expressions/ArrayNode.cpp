@@ -15,10 +15,13 @@
 #include "llvm/IR/Constant.h"
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/Module.h"
 #include "llvm/Support/Casting.h"
 
 ArrayNode::ArrayNode(std::vector<ExpressionNode*> elements, KType* type, ModuleCompiler& compiler)
-    : elements(std::move(elements))
+    : ExpressionNode(Kind::ArrayNode)
+    , elements(std::move(elements))
     , type(type)
     , compiler(compiler)
 {
@@ -57,23 +60,53 @@ void ArrayNode::check_types() const
 
 llvm::Value* ArrayNode::gen()
 {
-    auto* type = gen_type();
-    std::vector<llvm::Constant*> eval(elements.size());
+    auto* type = llvm::cast<llvm::ArrayType>(gen_type());
+    std::vector<llvm::Value*> values(elements.size());
+    std::vector<llvm::Constant*> constants;
+    constants.reserve(elements.size());
     for (size_t i = 0; i < elements.size(); i++) {
-        eval[i] = llvm::dyn_cast<llvm::Constant>(elements[i]->gen());
+        values[i] = elements[i]->gen();
+        if (auto* constant = llvm::dyn_cast<llvm::Constant>(values[i])) constants.push_back(constant);
     }
-    return llvm::ConstantArray::get(static_cast<llvm::ArrayType*>(type), eval);
+    if (constants.size() == values.size()) return llvm::ConstantArray::get(type, constants);
+
+    auto& builder = compiler.get_builder();
+    llvm::Value* array = llvm::PoisonValue::get(type);
+    for (size_t i = 0; i < values.size(); i++) {
+        array = builder.CreateInsertValue(array, values[i], { static_cast<unsigned>(i) });
+    }
+    return array;
 }
 
-llvm::Value* ArrayNode::gen_ptr() const
+void ArrayNode::gen_into(llvm::AllocaInst* destination)
 {
-    // For stack arrays, we need to create an alloca and store the array
-    auto* array_type = gen_type();
-    auto* alloca = compiler.get_builder().CreateAlloca(array_type, nullptr, "array_alloca");
+    auto& builder = compiler.get_builder();
+    auto* value = gen();
+    auto* constant = llvm::dyn_cast<llvm::Constant>(value);
+    if (!constant) {
+        builder.CreateStore(value, destination);
+        return;
+    }
+
+    // A constant initializer costs one memset or memcpy per execution instead of a store per element. When the local
+    // is never written, instcombine goes further and replaces it with the pooled global outright.
+    const auto size = compiler.get_module()->getDataLayout().getTypeAllocSize(constant->getType()).getFixedValue();
+    if (size == 0) return;
+    const auto align = destination->getAlign();
+    if (constant->isNullValue()) {
+        builder.CreateMemSet(destination, builder.getInt8(0), size, align);
+        return;
+    }
 
-    auto* array_value = const_cast<ArrayNode*>(this)->gen();
-    compiler.get_builder().CreateStore(array_value, alloca);
+    auto* global = compiler.get_constant_global(constant);
+    if (global->getAlign().valueOrOne() < align) global->setAlignment(align);
+    builder.CreateMemCpy(destination, align, global, global->getAlign(), size);
+}
 
+llvm::Value* ArrayNode::gen_ptr() const
+{
+    auto* alloca = compiler.create_entry_block_alloca(gen_type(), "array_alloca");
+    const_cast<ArrayNode*>(this)->gen_into(alloca);
     return alloca;
 }
 
@@ -85,11 +118,9 @@ llvm::Type* ArrayNode::gen_type() const
     return llvm::ArrayType::get(elements[0]->gen_type(), elements.size());
 }
 
-std::vector<ASTNode*> ArrayNode::get_children() const
+void ArrayNode::for_each_child(ChildCallback fn) const
 {
-    std::vector<ASTNode*> children(elements.size());
-    for (size_t i = 0; i < elements.size(); i++) {
-        children[i] = elements[i];
+    for (auto* element : elements) {
+        fn(element);
     }
-    return children;
 }
\ No newline at end of file
@@ -4,19 +4,22 @@
 #include <format>
 #include <stdexcept>
 
+#include "kyoto/AST/Expressions/ArrayIndexNode.h"
 #include "kyoto/AST/Expressions/ExpressionNode.h"
 #include "kyoto/AST/Expressions/UnaryNode.h"
 #include "kyoto/KType.h"
 #include "kyoto/ModuleCompiler.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/Instructions.h"
+#include "llvm/Support/Casting.h"
 
 namespace llvm {
 class Value;
 }
 
 AssignmentNode::AssignmentNode(ExpressionNode* assignee, ExpressionNode* expr, ModuleCompiler& compiler)
-    : assignee(assignee)
+    : ExpressionNode(Kind::AssignmentNode)
+    , assignee(assignee)
     , expr(expr)
     , compiler(compiler)
 {
@@ -35,7 +38,7 @@ std::string AssignmentNode::to_string() const
 
 llvm::Value* AssignmentNode::gen_deref_assignment() const
 {
-    auto* deref = dynamic_cast<UnaryNode*>(assignee);
+    auto* deref = llvm::dyn_cast<UnaryNode>(assignee);
     assert(deref && "Expected dereference unary node");
 
     auto* pktype = deref->get_ktype();
@@ -60,6 +63,10 @@ llvm::Value* AssignmentNode::gen()
         return gen_deref_assignment();
     }
 
+    if (const auto* lane = assignee->as<ArrayIndexNode>(); lane && lane->is_mask_lane()) {
+        return gen_mask_lane_assignment(lane);
+    }
+
     auto* alloc = assignee->gen_ptr();
     auto* type = assignee->get_ktype();
     auto name = assignee->to_string();
@@ -70,6 +77,13 @@ llvm::Value* AssignmentNode::gen()
     return expr_val;
 }
 
+llvm::Value* AssignmentNode::gen_mask_lane_assignment(const ArrayIndexNode* lane) const
+{
+    auto* expr_val = generate_expression_value(lane->get_ktype(), lane->to_string());
+    lane->gen_mask_lane_store(expr_val);
+    return expr_val;
+}
+
 void AssignmentNode::validate_lvalue() const
 {
     if (assignee->is_trivially_evaluable()) {
@@ -96,6 +110,10 @@ llvm::Value* AssignmentNode::generate_expression_value(const KType* type, const
         return expr->gen();
     }
 
+    if (type->is_vector() && expr->get_ktype()->is_vector() && type->operator==(*expr->get_ktype())) {
+        return expr->gen();
+    }
+
     if (ExpressionNode::can_convert_array_to_slice(type, expr->get_ktype())) {
         return ExpressionNode::convert_array_to_slice(expr, type, compiler);
     }
@@ -127,6 +145,10 @@ llvm::Type* AssignmentNode::gen_type() const
 
 llvm::Value* AssignmentNode::trivial_gen()
 {
+    if (const auto* lane = assignee->as<ArrayIndexNode>(); lane && lane->is_mask_lane()) {
+        return gen_mask_lane_assignment(lane);
+    }
+
     auto* alloc = assignee->gen_ptr();
     auto* type = assignee->get_ktype();
     auto name = assignee->to_string();
@@ -12,7 +12,9 @@
 #include "kyoto/ModuleCompiler.h"
 #include "kyoto/TypeResolver.h"
 #include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Instruction.h"
 #include "llvm/IR/Value.h"
+#include "llvm/Support/Casting.h"
 
 namespace {
 
@@ -33,30 +35,56 @@ void coerce_integer_literal_operands(ExpressionNode* lhs, ExpressionNode* rhs, M
 
     if (lhs_type->is_boolean() || rhs_type->is_boolean()) return;
 
-    if (auto* lhs_literal = dynamic_cast<NumberNode*>(lhs);
+    if (auto* lhs_literal = llvm::dyn_cast<NumberNode>(lhs);
         lhs_literal && rhs_type->is_integer() && *lhs_type != *rhs_type) {
         cast_literal_to(rhs_type, lhs_literal, compiler);
         return;
     }
 
-    if (auto* rhs_literal = dynamic_cast<NumberNode*>(rhs);
+    if (auto* rhs_literal = llvm::dyn_cast<NumberNode>(rhs);
         rhs_literal && lhs_type->is_integer() && *lhs_type != *rhs_type) {
         cast_literal_to(lhs_type, rhs_literal, compiler);
     }
 }
 
+// Returns the type shared by vector operands, or nullptr when neither operand is a vector.
+const VectorType* get_vector_operand_type(const ExpressionNode* lhs, const ExpressionNode* rhs, const char* op,
+                                          ModuleCompiler& compiler)
+{
+    const auto* lhs_ktype = lhs->get_ktype();
+    const auto* rhs_ktype = rhs->get_ktype();
+    if (!lhs_ktype->is_vector() && !rhs_ktype->is_vector()) return nullptr;
+
+    const auto* vector_type = compiler.get_type_resolver().resolve_vector_arith(lhs_ktype, rhs_ktype);
+    if (!vector_type) {
+        throw std::runtime_error(std::format("Operator `{}` cannot be applied to types `{}` and `{}`", op,
+                                             lhs_ktype->to_string(), rhs_ktype->to_string()));
+    }
+    return vector_type;
+}
+
+llvm::Value* gen_vector_arith(ExpressionNode* lhs, ExpressionNode* rhs, const VectorType* vector_type,
+                              llvm::Instruction::BinaryOps int_opcode, llvm::Instruction::BinaryOps float_opcode,
+                              const char* name, ModuleCompiler& compiler)
+{
+    auto* lhs_val = lhs->gen();
+    auto* rhs_val = rhs->gen();
+    const auto opcode = vector_type->get_element_type()->is_floating_point() ? float_opcode : int_opcode;
+    return compiler.get_builder().CreateBinOp(opcode, lhs_val, rhs_val, name);
 }
 
-#define ARITH_BINARY_NODE_IMPL_BASE(name, op, llvm_op)                                                            \
+}
+
+#define ARITH_BINARY_NODE_IMPL_BASE(name, op, llvm_op, int_opcode, float_opcode)                                  \
     name::name(ExpressionNode* lhs, ExpressionNode* rhs, ModuleCompiler& compiler)                                \
-        : lhs(lhs)                                                                                                \
+        : ExpressionNode(Kind::name)                                                                              \
+        , lhs(lhs)                                                                                                \
         , rhs(rhs)                                                                                                \
         , compiler(compiler)                                                                                      \
     {                                                                                                             \
     }                                                                                                             \
     name::~name()                                                                                                 \
     {                                                                                                             \
-        delete type;                                                                                              \
         delete lhs;                                                                                               \
         delete rhs;                                                                                               \
     }                                                                                                             \
@@ -66,6 +94,10 @@ void coerce_integer_literal_operands(ExpressionNode* lhs, ExpressionNode* rhs, M
     }                                                                                                             \
     llvm::Value* name::gen()                                                                                      \
     {                                                                                                             \
+        if (const auto* vector_type = get_vector_operand_type(lhs, rhs, #op, compiler)) {                         \
+            return gen_vector_arith(lhs, rhs, vector_type, llvm::Instruction::int_opcode,                         \
+                                    llvm::Instruction::float_opcode, #op "val", compiler);                        \
+        }                                                                                                         \
         auto* lhs_val = lhs->gen();                                                                               \
         auto* rhs_val = rhs->gen();                                                                               \
         auto* lhs_ktype = lhs->get_ktype()->as<PrimitiveType>();                                                  \
@@ -85,6 +117,9 @@ void coerce_integer_literal_operands(ExpressionNode* lhs, ExpressionNode* rhs, M
     }                                                                                                             \
     llvm::Type* name::gen_type() const                                                                            \
     {                                                                                                             \
+        if (const auto* vector_type = get_vector_operand_type(lhs, rhs, #op, compiler)) {                         \
+            return ASTNode::get_llvm_type(vector_type, compiler);                                                 \
+        }                                                                                                         \
         coerce_integer_literal_operands(lhs, rhs, compiler);                                                      \
         auto* lhs_ktype = lhs->get_ktype()->as<PrimitiveType>();                                                  \
         auto* rhs_ktype = rhs->get_ktype()->as<PrimitiveType>();                                                  \
@@ -93,14 +128,14 @@ void coerce_integer_literal_operands(ExpressionNode* lhs, ExpressionNode* rhs, M
             throw std::runtime_error(std::format("Operator `{}` cannot be applied to types `{}` and `{}`", #op,   \
                                                  lhs_ktype->to_string(), rhs_ktype->to_string()));                \
         }                                                                                                         \
-        auto ktype = new PrimitiveType(t.value());                                                                \
-        auto res = ASTNode::get_llvm_type(ktype, compiler);                                                       \
-        delete ktype;                                                                                             \
-        return res;                                                                                               \
+        return ASTNode::get_llvm_type(compiler.get_type_context().primitive(t.value()), compiler);                \
     }                                                                                                             \
     KType* name::get_ktype() const                                                                                \
     {                                                                                                             \
         if (type) return type;                                                                                    \
+        if (const auto* vector_type = get_vector_operand_type(lhs, rhs, #op, compiler)) {                         \
+            return type = compiler.get_type_context().intern(vector_type);                                        \
+        }                                                                                                         \
         coerce_integer_literal_operands(lhs, rhs, compiler);                                                      \
         auto* lhs_ktype = lhs->get_ktype()->as<PrimitiveType>();                                                  \
         auto* rhs_ktype = rhs->get_ktype()->as<PrimitiveType>();                                                  \
@@ -109,42 +144,42 @@ void coerce_integer_literal_operands(ExpressionNode* lhs, ExpressionNode* rhs, M
             throw std::runtime_error(std::format("Operator `{}` cannot be applied to types `{}` and `{}`", #op,   \
                                                  lhs_ktype->to_string(), rhs_ktype->to_string()));                \
         }                                                                                                         \
-        return type = new PrimitiveType(t.value());                                                               \
+        return type = compiler.get_type_context().primitive(t.value());                                           \
     }
 
-#define ARITH_BINARY_NODE_IMPL_WITH_TRIVIAL_EVAL(name, op, llvm_op)            \
-    ARITH_BINARY_NODE_IMPL_BASE(name, op, llvm_op)                             \
-    llvm::Value* name::trivial_gen()                                           \
-    {                                                                          \
-        assert(is_trivially_evaluable());                                      \
-        auto* lhs_val = lhs->trivial_gen();                                    \
-        auto* rhs_val = rhs->trivial_gen();                                    \
-        return compiler.get_builder().llvm_op(lhs_val, rhs_val, #op "val");    \
-    }                                                                          \
-    bool name::is_trivially_evaluable() const                                  \
-    {                                                                          \
-        return lhs->is_trivially_evaluable() && rhs->is_trivially_evaluable(); \
+#define ARITH_BINARY_NODE_IMPL_WITH_TRIVIAL_EVAL(name, op, llvm_op, int_opcode, float_opcode) \
+    ARITH_BINARY_NODE_IMPL_BASE(name, op, llvm_op, int_opcode, float_opcode)                  \
+    llvm::Value* name::trivial_gen()                                                          \
+    {                                                                                         \
+        assert(is_trivially_evaluable());                                                     \
+        auto* lhs_val = lhs->trivial_gen();                                                   \
+        auto* rhs_val = rhs->trivial_gen();                                                   \
+        return compiler.get_builder().llvm_op(lhs_val, rhs_val, #op "val");                   \
+    }                                                                                         \
+    bool name::is_trivially_evaluable() const                                                 \
+    {                                                                                         \
+        return lhs->is_trivially_evaluable() && rhs->is_trivially_evaluable();                \
     }
 
-#define ARITH_BINARY_NODE_IMPL_NO_TRIVIAL_EVAL(name, op, llvm_op)              \
-    ARITH_BINARY_NODE_IMPL_BASE(name, op, llvm_op)                             \
-    llvm::Value* name::trivial_gen()                                           \
-    {                                                                          \
-        assert(is_trivially_evaluable());                                      \
-        auto* lhs_val = lhs->trivial_gen();                                    \
-        auto* rhs_val = rhs->trivial_gen();                                    \
-        return compiler.get_builder().llvm_op(lhs_val, rhs_val, #op "val");    \
-    }                                                                          \
-    bool name::is_trivially_evaluable() const                                  \
-    {                                                                          \
-        return lhs->is_trivially_evaluable() && rhs->is_trivially_evaluable(); \
+#define ARITH_BINARY_NODE_IMPL_NO_TRIVIAL_EVAL(name, op, llvm_op, int_opcode, float_opcode) \
+    ARITH_BINARY_NODE_IMPL_BASE(name, op, llvm_op, int_opcode, float_opcode)                \
+    llvm::Value* name::trivial_gen()                                                        \
+    {                                                                                       \
+        assert(is_trivially_evaluable());                                                   \
+        auto* lhs_val = lhs->trivial_gen();                                                 \
+        auto* rhs_val = rhs->trivial_gen();                                                 \
+        return compiler.get_builder().llvm_op(lhs_val, rhs_val, #op "val");                 \
+    }                                                                                       \
+    bool name::is_trivially_evaluable() const                                               \
+    {                                                                                       \
+        return lhs->is_trivially_evaluable() && rhs->is_trivially_evaluable();              \
     }
 
-ARITH_BINARY_NODE_IMPL_WITH_TRIVIAL_EVAL(MulNode, *, CreateMul);
-ARITH_BINARY_NODE_IMPL_WITH_TRIVIAL_EVAL(AddNode, +, CreateAdd);
-ARITH_BINARY_NODE_IMPL_WITH_TRIVIAL_EVAL(SubNode, -, CreateSub);
-ARITH_BINARY_NODE_IMPL_NO_TRIVIAL_EVAL(DivNode, /, CreateSDiv);
-ARITH_BINARY_NODE_IMPL_NO_TRIVIAL_EVAL(ModNode, %, CreateSRem);
+ARITH_BINARY_NODE_IMPL_WITH_TRIVIAL_EVAL(MulNode, *, CreateMul, Mul, FMul);
+ARITH_BINARY_NODE_IMPL_WITH_TRIVIAL_EVAL(AddNode, +, CreateAdd, Add, FAdd);
+ARITH_BINARY_NODE_IMPL_WITH_TRIVIAL_EVAL(SubNode, -, CreateSub, Sub, FSub);
+ARITH_BINARY_NODE_IMPL_NO_TRIVIAL_EVAL(DivNode, /, CreateSDiv, SDiv, FDiv);
+ARITH_BINARY_NODE_IMPL_NO_TRIVIAL_EVAL(ModNode, %, CreateSRem, SRem, FRem);
 
 #undef ARITH_BINARY_NODE_IMPL_WITH_TRIVIAL_EVAL
 #undef ARITH_BINARY_NODE_IMPL_NO_TRIVIAL_EVAL
@@ -4,6 +4,7 @@
 #include <stdexcept>
 #include <string>
 
+#include "kyoto/AST/ASTNode.h"
 #include "kyoto/AST/Expressions/BinaryNode.h"
 #include "kyoto/AST/Expressions/ExpressionNode.h"
 #include "kyoto/KType.h"
@@ -11,19 +12,41 @@
 #include "kyoto/TypeResolver.h"
 #include "llvm/IR/DerivedTypes.h"
 #include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/InstrTypes.h"
 #include "llvm/IR/Type.h"
 #include "llvm/IR/Value.h"
 
-#define CMP_BINARY_NODE_IMPL(name, op, llvm_sop)                                                                \
+namespace {
+
+// Returns the lane mask produced by comparing vector operands, or nullptr when neither operand is a vector.
+VectorType* get_vector_mask_type(const ExpressionNode* lhs, const ExpressionNode* rhs, const char* op,
+                                 ModuleCompiler& compiler)
+{
+    const auto* lhs_ktype = lhs->get_ktype();
+    const auto* rhs_ktype = rhs->get_ktype();
+    if (!lhs_ktype->is_vector() && !rhs_ktype->is_vector()) return nullptr;
+
+    const auto* vector_type = compiler.get_type_resolver().resolve_vector_cmp(lhs_ktype, rhs_ktype);
+    if (!vector_type) {
+        throw std::runtime_error(std::format("Operator `{}` cannot be applied to types `{}` and `{}`", op,
+                                             lhs_ktype->to_string(), rhs_ktype->to_string()));
+    }
+    auto& types = compiler.get_type_context();
+    return types.vector(types.primitive(PrimitiveType::Kind::Boolean), vector_type->get_lanes());
+}
+
+}
+
+#define CMP_BINARY_NODE_IMPL(name, op, llvm_sop, int_predicate, float_predicate)                                \
     name::name(ExpressionNode* lhs, ExpressionNode* rhs, ModuleCompiler& compiler)                              \
-        : lhs(lhs)                                                                                              \
+        : ExpressionNode(Kind::name)                                                                            \
+        , lhs(lhs)                                                                                              \
         , rhs(rhs)                                                                                              \
         , compiler(compiler)                                                                                    \
     {                                                                                                           \
     }                                                                                                           \
     name::~name()                                                                                               \
     {                                                                                                           \
-        delete type;                                                                                            \
         delete lhs;                                                                                             \
         delete rhs;                                                                                             \
     }                                                                                                           \
@@ -35,6 +58,12 @@
     {                                                                                                           \
         auto* lhs_val = lhs->gen();                                                                             \
         auto* rhs_val = rhs->gen();                                                                             \
+        if (get_vector_mask_type(lhs, rhs, #op, compiler)) {                                                    \
+            const auto* element_type = lhs->get_ktype()->as<VectorType>()->get_element_type();                  \
+            const auto predicate = element_type->is_floating_point() ? llvm::CmpInst::float_predicate           \
+                                                                     : llvm::CmpInst::int_predicate;            \
+            return compiler.get_builder().CreateCmp(predicate, lhs_val, rhs_val, #op "val");                    \
+        }                                                                                                       \
         auto* lhs_ktype = lhs->get_ktype()->as<PrimitiveType>();                                                \
         auto* rhs_ktype = rhs->get_ktype()->as<PrimitiveType>();                                                \
         if (lhs_ktype->width() > rhs_ktype->width()) {                                                          \
@@ -54,6 +83,9 @@
     }                                                                                                           \
     llvm::Type* name::gen_type() const                                                                          \
     {                                                                                                           \
+        if (const auto* mask_type = get_vector_mask_type(lhs, rhs, #op, compiler)) {                            \
+            return ASTNode::get_llvm_type(mask_type, compiler);                                                 \
+        }                                                                                                       \
         return llvm::Type::getInt1Ty(compiler.get_context());                                                   \
     }                                                                                                           \
     bool name::is_trivially_evaluable() const                                                                   \
@@ -70,14 +102,15 @@
     KType* name::get_ktype() const                                                                              \
     {                                                                                                           \
         if (type) return type;                                                                                  \
-        return type = new PrimitiveType(PrimitiveType::Kind::Boolean);                                          \
+        if (auto* mask_type = get_vector_mask_type(lhs, rhs, #op, compiler)) return type = mask_type;           \
+        return type = compiler.get_type_context().primitive(PrimitiveType::Kind::Boolean);                      \
     }
 
-CMP_BINARY_NODE_IMPL(EqNode, ==, CreateICmpEQ);
-CMP_BINARY_NODE_IMPL(NotEqNode, !=, CreateICmpNE);
-CMP_BINARY_NODE_IMPL(LessNode, <, CreateICmpSLT);
-CMP_BINARY_NODE_IMPL(GreaterNode, >, CreateICmpSGT);
-CMP_BINARY_NODE_IMPL(LessEqNode, <=, CreateICmpSLE);
-CMP_BINARY_NODE_IMPL(GreaterEqNode, >=, CreateICmpSGE);
+CMP_BINARY_NODE_IMPL(EqNode, ==, CreateICmpEQ, ICMP_EQ, FCMP_OEQ);
+CMP_BINARY_NODE_IMPL(NotEqNode, !=, CreateICmpNE, ICMP_NE, FCMP_UNE);
+CMP_BINARY_NODE_IMPL(LessNode, <, CreateICmpSLT, ICMP_SLT, FCMP_OLT);
+CMP_BINARY_NODE_IMPL(GreaterNode, >, CreateICmpSGT, ICMP_SGT, FCMP_OGT);
+CMP_BINARY_NODE_IMPL(LessEqNode, <=, CreateICmpSLE, ICMP_SLE, FCMP_OLE);
+CMP_BINARY_NODE_IMPL(GreaterEqNode, >=, CreateICmpSGE, ICMP_SGE, FCMP_OGE);
 
 #undef CMP_BINARY_NODE_IMPL
\ No newline at end of file
@@ -15,14 +15,14 @@
 
 #define LOGICAL_BINARY_NODE_IMPL(name, op, llvm_op)                                                                 \
     name::name(ExpressionNode* lhs, ExpressionNode* rhs, ModuleCompiler& compiler)                                  \
-        : lhs(lhs)                                                                                                  \
+        : ExpressionNode(Kind::name)                                                                                \
+        , lhs(lhs)                                                                                                  \
         , rhs(rhs)                                                                                                  \
         , compiler(compiler)                                                                                        \
     {                                                                                                               \
     }                                                                                                               \
     name::~name()                                                                                                   \
     {                                                                                                               \
-        delete type;                                                                                                \
         delete lhs;                                                                                                 \
         delete rhs;                                                                                                 \
     }                                                                                                               \
@@ -68,7 +68,7 @@
     KType* name::get_ktype() const                                                                                  \
     {                                                                                                               \
         if (type) return type;                                                                                      \
-        return type = new PrimitiveType(PrimitiveType::Kind::Boolean);                                              \
+        return type = compiler.get_type_context().primitive(PrimitiveType::Kind::Boolean);                          \
     }
 
 LOGICAL_BINARY_NODE_IMPL(LogicalAndNode, &&, CreateAnd);
@@ -4,6 +4,7 @@
 #include <llvm/IR/Constant.h>
 #include <llvm/IR/Constants.h>
 #include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Type.h>
 #include <llvm/Support/Casting.h>
 #include <stdexcept>
 
@@ -15,7 +16,8 @@ class Value;
 }
 
 CastNode::CastNode(KType* type, ExpressionNode* expr, ModuleCompiler& compiler)
-    : type(type)
+    : ExpressionNode(Kind::CastNode)
+    , type(type)
     , expr(expr)
     , compiler(compiler)
 {
@@ -77,6 +79,57 @@ llvm::Value* CastNode::handle_integer_cast()
     return ExpressionNode::dynamic_integer_conversion(expr_val, expr_ktype, target_ktype, compiler);
 }
 
+llvm::Value* CastNode::handle_vector_cast()
+{
+    const auto* expr_ktype = expr->get_ktype();
+    const auto* target_ktype = type->as<VectorType>();
+    const auto* element_ktype = target_ktype->get_element_type();
+
+    if (expr_ktype->is_vector()) {
+        const auto* source_ktype = expr_ktype->as<VectorType>();
+        if (source_ktype->get_lanes() != target_ktype->get_lanes()) throw_incompatible_cast_error(expr_ktype, type);
+        return convert_lanes(expr->gen(), source_ktype->get_element_type(), element_ktype);
+    }
+
+    // A scalar is splat across every lane, after the same conversion an assignment to one lane would apply.
+    llvm::Value* scalar = nullptr;
+    if ((element_ktype->is_integer() && expr_ktype->is_integer())
+        || (element_ktype->is_boolean() && expr_ktype->is_boolean())) {
+        scalar = ExpressionNode::handle_integer_conversion(expr, element_ktype, compiler, "splat");
+    } else if (element_ktype->is_floating_point() && expr_ktype->is_numeric()) {
+        scalar = convert_lanes(expr->gen(), expr_ktype, element_ktype);
+    } else {
+        throw_incompatible_cast_error(expr_ktype, type);
+    }
+    return compiler.get_builder().CreateVectorSplat(target_ktype->get_lanes(), scalar, "splat");
+}
+
+// Integer lanes may only widen, as in scalar casts. Masks become 0 or 1 per lane, and conversions to or from floating
+// point lanes round like C.
+llvm::Value* CastNode::convert_lanes(llvm::Value* value, const KType* from, const KType* to) const
+{
+    if (*from == *to) return value;
+
+    auto& builder = compiler.get_builder();
+    // Keeps the lane count of `value`, or none when it is a scalar about to be splat.
+    auto* target_llvm_type = value->getType()->getWithNewType(get_llvm_type(to, compiler));
+    if (from->is_boolean() && to->is_integer()) return builder.CreateZExt(value, target_llvm_type, "lanes");
+    if (from->is_integer() && to->is_integer()) {
+        if (from->as<PrimitiveType>()->width() > to->as<PrimitiveType>()->width()) {
+            throw_incompatible_cast_error(expr->get_ktype(), type);
+        }
+        return builder.CreateSExt(value, target_llvm_type, "lanes");
+    }
+    if (from->is_integer() && to->is_floating_point()) return builder.CreateSIToFP(value, target_llvm_type, "lanes");
+    if (from->is_floating_point() && to->is_integer()) return builder.CreateFPToSI(value, target_llvm_type, "lanes");
+    if (from->is_floating_point() && to->is_floating_point()) {
+        return builder.CreateFPCast(value, target_llvm_type, "lanes");
+    }
+
+    throw_incompatible_cast_error(expr->get_ktype(), type);
+    return nullptr; // Unreachable
+}
+
 llvm::Value* CastNode::gen()
 {
     // Supported casting scenarios:
@@ -84,6 +137,7 @@ llvm::Value* CastNode::gen()
     // - Boolean to boolean casts
     // - Arbitrary pointer conversions (e.g., T* to U*)
     // - Identity casts (e.g., T to T)
+    // - Splatting a scalar across a vector (e.g., i32 to i32x8) and lane-wise vector conversions
     // Prohibited casting scenarios:
     // - Narrowing integer conversions (e.g., i32 to i8)
     // - Pointer to integer or integer to pointer conversions
@@ -101,6 +155,10 @@ llvm::Value* CastNode::gen()
         return expr->gen();
     }
 
+    if (target_ktype->is_vector()) {
+        return handle_vector_cast();
+    }
+
     if (expr_ktype->is_pointer() && target_ktype->is_pointer()) {
         // Pointer to pointer casts are always allowed - just bitcast the pointer
         auto* expr_val = expr->gen();
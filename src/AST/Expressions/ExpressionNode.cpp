@@ -74,7 +74,7 @@ llvm::Value* ExpressionNode::handle_integer_conversion(ExpressionNode* expr, con
                                                        ModuleCompiler& compiler, const std::string& what,
                                                        const std::string& target_name)
 {
-    auto* target_type = dynamic_cast<const PrimitiveType*>(target_ktype);
+    auto* target_type = llvm::dyn_cast<PrimitiveType>(target_ktype);
     auto* expr_ktype = expr->get_ktype()->as<PrimitiveType>();
     bool is_compatible = compiler.get_type_resolver().promotable_to(expr_ktype->get_kind(), target_type->get_kind());
     bool is_trivially_evaluable = expr->is_trivially_evaluable();
@@ -11,12 +11,14 @@
 #include "kyoto/AST/Expressions/ExpressionNode.h"
 #include "kyoto/KType.h"
 #include "kyoto/ModuleCompiler.h"
+#include "kyoto/SymbolTable.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Value.h"
+#include "llvm/Support/Casting.h"
 
 namespace {
 
@@ -90,6 +92,13 @@ ArgumentMatch match_candidate(FunctionNode* candidate, const std::vector<Express
 std::optional<FunctionNode*> select_overload(const std::string& name, const std::vector<ExpressionNode*>& args,
                                              ModuleCompiler& compiler, size_t total_arity, size_t param_offset)
 {
+    ModuleCompiler::CallSignature signature;
+    signature.reserve(args.size());
+    for (auto* arg : args) {
+        signature.emplace_back(compiler.get_type_context().intern(arg->get_ktype()), arg->is_trivially_evaluable());
+    }
+    if (auto fn = compiler.get_resolved_call(name, param_offset, signature); fn.has_value()) return fn;
+
     auto candidates = compiler.get_functions(name, total_arity);
     std::vector<FunctionNode*> exact_matches;
     std::vector<FunctionNode*> conversion_matches;
@@ -107,19 +116,17 @@ std::optional<FunctionNode*> select_overload(const std::string& name, const std:
         }
     }
 
-    if (exact_matches.size() == 1) return exact_matches.front();
-    if (exact_matches.size() > 1) {
-        throw std::runtime_error(std::format("Call to function `{}` with argument types ({}) is ambiguous", name,
-                                             format_argument_types(args)));
-    }
-
-    if (conversion_matches.size() == 1) return conversion_matches.front();
-    if (conversion_matches.size() > 1) {
+    FunctionNode* selected = nullptr;
+    if (exact_matches.size() > 1 || (exact_matches.empty() && conversion_matches.size() > 1)) {
         throw std::runtime_error(std::format("Call to function `{}` with argument types ({}) is ambiguous", name,
                                              format_argument_types(args)));
     }
+    if (exact_matches.size() == 1) selected = exact_matches.front();
+    if (exact_matches.empty() && conversion_matches.size() == 1) selected = conversion_matches.front();
+    if (!selected) return std::nullopt;
 
-    return std::nullopt;
+    compiler.cache_resolved_call(name, param_offset, std::move(signature), selected);
+    return selected;
 }
 
 std::optional<FunctionNode*> select_declared_function(const std::string& name, const std::vector<ExpressionNode*>& args,
@@ -177,6 +184,7 @@ std::vector<llvm::Value*> build_call_arg_values(FunctionNode* fn_meta, const std
             || (param_type->is_string() && arg_type->is_string())
             || (param_type->is_array() && arg_type->is_array() && *param_type == *arg_type)
             || (param_type->is_slice() && arg_type->is_slice() && *param_type == *arg_type)
+            || (param_type->is_vector() && arg_type->is_vector() && *param_type == *arg_type)
             || (param_type->is_class() && arg_type->is_class() && *param_type == *arg_type)
             || (param_type->is_function() && arg_type->is_function() && *param_type == *arg_type)) {
             arg_values.push_back(arg->gen());
@@ -224,6 +232,7 @@ std::vector<llvm::Value*> build_call_arg_values(const FunctionType* function_typ
             || (param_type->is_string() && arg_type->is_string())
             || (param_type->is_array() && arg_type->is_array() && *param_type == *arg_type)
             || (param_type->is_slice() && arg_type->is_slice() && *param_type == *arg_type)
+            || (param_type->is_vector() && arg_type->is_vector() && *param_type == *arg_type)
             || (param_type->is_class() && arg_type->is_class() && *param_type == *arg_type)
             || (param_type->is_function() && arg_type->is_function() && *param_type == *arg_type)) {
             arg_values.push_back(arg->gen());
@@ -246,14 +255,21 @@ std::vector<llvm::Value*> build_call_arg_values(const FunctionType* function_typ
 } // namespace
 
 FunctionCall::FunctionCall(std::string name, std::vector<ExpressionNode*> args, ModuleCompiler& compiler)
-    : name(std::move(name))
+    : FunctionCall(Kind::FunctionCall, std::move(name), std::move(args), compiler)
+{
+}
+
+FunctionCall::FunctionCall(Kind kind, std::string name, std::vector<ExpressionNode*> args, ModuleCompiler& compiler)
+    : ExpressionNode(kind)
+    , name(std::move(name))
     , args(std::move(args))
     , compiler(compiler)
 {
 }
 
 FunctionCall::FunctionCall(ExpressionNode* callee, std::vector<ExpressionNode*> args, ModuleCompiler& compiler)
-    : callee(callee)
+    : ExpressionNode(Kind::FunctionCall)
+    , callee(callee)
     , args(std::move(args))
     , compiler(compiler)
 {
@@ -281,35 +297,39 @@ std::string FunctionCall::to_string() const
 
 namespace {
 
-const FunctionType* get_symbol_function_type(const std::string& name, ModuleCompiler& compiler)
+const FunctionType* get_symbol_function_type(const std::optional<Symbol>& symbol)
 {
-    auto symbol = compiler.get_symbol(name);
-    if (symbol.has_value()) return dynamic_cast<const FunctionType*>(symbol->type);
+    return symbol.has_value() ? llvm::dyn_cast_if_present<FunctionType>(symbol->type) : nullptr;
+}
 
-    if (const auto pos = name.rfind("__"); pos != std::string::npos) {
-        symbol = compiler.get_symbol(name.substr(pos + 2));
-        if (symbol.has_value()) return dynamic_cast<const FunctionType*>(symbol->type);
-    }
+llvm::Value* build_symbol_function_callee(const Symbol& symbol, const std::string& name, ModuleCompiler& compiler)
+{
+    return compiler.get_builder().CreateLoad(symbol.alloc->getAllocatedType(), symbol.alloc, name);
+}
 
-    return nullptr;
 }
 
-llvm::Value* build_symbol_function_callee(const std::string& name, ModuleCompiler& compiler)
+std::optional<Symbol> FunctionCall::find_symbol() const
 {
-    auto symbol = compiler.get_symbol(name);
-    if (!symbol.has_value() && name.rfind("__") != std::string::npos) {
-        symbol = compiler.get_symbol(name.substr(name.rfind("__") + 2));
+    if (!symbol_ids.has_value()) {
+        const auto pos = name.rfind("__");
+        symbol_ids = SymbolIds {
+            compiler.intern_symbol(name),
+            pos == std::string::npos ? std::nullopt : std::optional { compiler.intern_symbol(name.substr(pos + 2)) },
+        };
     }
-    if (!symbol.has_value()) throw std::runtime_error(std::format("Unknown symbol `{}`", name));
-    return compiler.get_builder().CreateLoad(symbol->alloc->getAllocatedType(), symbol->alloc, name);
-}
 
+    auto symbol = compiler.get_symbol(symbol_ids->name);
+    if (!symbol.has_value() && symbol_ids->unqualified.has_value()) {
+        symbol = compiler.get_symbol(*symbol_ids->unqualified);
+    }
+    return symbol;
 }
 
 llvm::Value* FunctionCall::gen()
 {
     if (callee) {
-        const auto* function_type = dynamic_cast<const FunctionType*>(callee->get_ktype());
+        const auto* function_type = llvm::dyn_cast_if_present<FunctionType>(callee->get_ktype());
         if (!function_type) {
             throw std::runtime_error(std::format("Cannot call non-function expression `{}` of type `{}`",
                                                  callee->to_string(), callee->get_ktype()->to_string()));
@@ -320,10 +340,11 @@ llvm::Value* FunctionCall::gen()
                                                  arg_values);
     }
 
-    if (const auto* function_type = get_symbol_function_type(name, compiler)) {
+    const auto symbol = find_symbol();
+    if (const auto* function_type = get_symbol_function_type(symbol)) {
         const auto arg_values = build_call_arg_values(function_type, args, compiler, name);
         return compiler.get_builder().CreateCall(build_llvm_function_type(function_type, compiler),
-                                                 build_symbol_function_callee(name, compiler), arg_values);
+                                                 build_symbol_function_callee(*symbol, name, compiler), arg_values);
     }
 
     if (name == "main") {
@@ -374,7 +395,7 @@ llvm::Value* FunctionCall::gen_ptr() const
 {
     assert(get_ktype()->is_pointer() && "Function does not return a pointer");
     if (callee) {
-        const auto* function_type = dynamic_cast<const FunctionType*>(callee->get_ktype());
+        const auto* function_type = llvm::dyn_cast_if_present<FunctionType>(callee->get_ktype());
         if (!function_type) {
             throw std::runtime_error(std::format("Cannot call non-function expression `{}` of type `{}`",
                                                  callee->to_string(), callee->get_ktype()->to_string()));
@@ -385,10 +406,11 @@ llvm::Value* FunctionCall::gen_ptr() const
                                                  arg_values);
     }
 
-    if (const auto* function_type = get_symbol_function_type(name, compiler)) {
+    const auto symbol = find_symbol();
+    if (const auto* function_type = get_symbol_function_type(symbol)) {
         const auto arg_values = build_call_arg_values(function_type, args, compiler, name);
         return compiler.get_builder().CreateCall(build_llvm_function_type(function_type, compiler),
-                                                 build_symbol_function_callee(name, compiler), arg_values);
+                                                 build_symbol_function_callee(*symbol, name, compiler), arg_values);
     }
 
     if (is_constructor_call() && !destination) {
@@ -418,7 +440,7 @@ llvm::Value* FunctionCall::gen_ptr() const
 llvm::Type* FunctionCall::gen_type() const
 {
     if (callee) {
-        const auto* function_type = dynamic_cast<const FunctionType*>(callee->get_ktype());
+        const auto* function_type = llvm::dyn_cast_if_present<FunctionType>(callee->get_ktype());
         if (!function_type) {
             throw std::runtime_error(std::format("Cannot call non-function expression `{}` of type `{}`",
                                                  callee->to_string(), callee->get_ktype()->to_string()));
@@ -426,7 +448,7 @@ llvm::Type* FunctionCall::gen_type() const
         return ASTNode::get_llvm_type(function_type->get_return_type(), compiler);
     }
 
-    if (const auto* function_type = get_symbol_function_type(name, compiler)) {
+    if (const auto* function_type = get_symbol_function_type(find_symbol())) {
         return ASTNode::get_llvm_type(function_type->get_return_type(), compiler);
     }
 
@@ -452,7 +474,7 @@ llvm::Value* FunctionCall::trivial_gen()
 KType* FunctionCall::get_ktype() const
 {
     if (callee) {
-        const auto* function_type = dynamic_cast<const FunctionType*>(callee->get_ktype());
+        const auto* function_type = llvm::dyn_cast_if_present<FunctionType>(callee->get_ktype());
         if (!function_type) {
             throw std::runtime_error(std::format("Cannot call non-function expression `{}` of type `{}`",
                                                  callee->to_string(), callee->get_ktype()->to_string()));
@@ -460,7 +482,7 @@ KType* FunctionCall::get_ktype() const
         return function_type->get_return_type();
     }
 
-    if (const auto* function_type = get_symbol_function_type(name, compiler)) {
+    if (const auto* function_type = get_symbol_function_type(find_symbol())) {
         return const_cast<FunctionType*>(function_type)->get_return_type();
     }
 
@@ -490,10 +512,10 @@ void FunctionCall::insert_arg(ExpressionNode* node, size_t index)
     args.insert(args.begin() + index, node);
 }
 
-std::vector<ASTNode*> FunctionCall::get_children() const
+void FunctionCall::for_each_child(ChildCallback fn) const
 {
-    std::vector<ASTNode*> children;
-    if (callee) children.push_back(callee);
-    children.insert(children.end(), args.begin(), args.end());
-    return children;
+    if (callee) fn(callee);
+    for (auto* arg : args) {
+        fn(arg);
+    }
 }
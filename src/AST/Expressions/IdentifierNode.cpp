@@ -36,8 +36,10 @@ FunctionType* copy_function_type(FunctionNode* fn)
 } // namespace
 
 IdentifierExpressionNode::IdentifierExpressionNode(std::string name, ModuleCompiler& compiler)
-    : name(std::move(name))
+    : ExpressionNode(Kind::IdentifierExpressionNode)
+    , name(std::move(name))
     , compiler(compiler)
+    , symbol_id(compiler.intern_symbol(this->name))
 {
 }
 
@@ -48,7 +50,7 @@ std::string IdentifierExpressionNode::to_string() const
 
 llvm::Value* IdentifierExpressionNode::gen()
 {
-    auto symbol_opt = compiler.get_symbol(name);
+    auto symbol_opt = compiler.get_symbol(symbol_id);
     if (symbol_opt.has_value()) {
         auto symbol = symbol_opt.value();
         return compiler.get_builder().CreateLoad(symbol.alloc->getAllocatedType(), symbol.alloc, name);
@@ -64,7 +66,7 @@ llvm::Value* IdentifierExpressionNode::gen()
 
 llvm::Value* IdentifierExpressionNode::gen_ptr() const
 {
-    auto symbol_opt = compiler.get_symbol(name);
+    auto symbol_opt = compiler.get_symbol(symbol_id);
     if (!symbol_opt.has_value()) {
         throw std::runtime_error(std::format("Unknown symbol `{}`", name));
     }
@@ -74,7 +76,7 @@ llvm::Value* IdentifierExpressionNode::gen_ptr() const
 
 llvm::Type* IdentifierExpressionNode::gen_type() const
 {
-    auto symbol = compiler.get_symbol(name);
+    auto symbol = compiler.get_symbol(symbol_id);
     if (symbol.has_value()) {
         return symbol.value().alloc->getAllocatedType();
     }
@@ -87,7 +89,7 @@ llvm::Type* IdentifierExpressionNode::gen_type() const
 
 KType* IdentifierExpressionNode::get_ktype() const
 {
-    auto symbol = compiler.get_symbol(name);
+    auto symbol = compiler.get_symbol(symbol_id);
     if (symbol.has_value()) {
         return symbol.value().type;
     }
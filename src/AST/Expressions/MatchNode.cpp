@@ -5,15 +5,20 @@
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/Instructions.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdexcept>
+#include <unordered_set>
 #include <utility>
 
 #include "kyoto/AST/ASTNode.h"
 #include "kyoto/KType.h"
 #include "kyoto/ModuleCompiler.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/Support/Casting.h"
 
 MatchNode::MatchNode(ExpressionNode* expr, std::vector<Case> cases, ModuleCompiler& compiler)
-    : expr(expr)
+    : ExpressionNode(Kind::MatchNode)
+    , expr(expr)
     , cases(std::move(cases))
     , type(nullptr)
     , compiler(compiler)
@@ -46,6 +51,7 @@ llvm::Value* MatchNode::gen()
     init_ktype();
 
     if (cases.size() == 1) return gen_default_only();
+    if (can_gen_switch()) return gen_switch();
 
     auto* match_expr_val = expr->gen();
 
@@ -91,6 +97,57 @@ llvm::Value* MatchNode::gen()
     return phi;
 }
 
+bool MatchNode::can_gen_switch() const
+{
+    const auto* expr_ktype = expr->get_ktype();
+    if (!expr_ktype->is_integer() && !expr_ktype->is_char() && !expr_ktype->is_boolean()) return false;
+
+    for (size_t i = 0; i < cases.size() - 1; ++i) {
+        const auto* cond_ktype = cases[i].cond->get_ktype();
+        if (!cases[i].cond->is_trivially_evaluable()) return false;
+        if (!cond_ktype->is_integer() && !cond_ktype->is_char() && !cond_ktype->is_boolean()) return false;
+    }
+
+    return true;
+}
+
+llvm::Value* MatchNode::gen_switch()
+{
+    auto& builder = compiler.get_builder();
+    const auto* expr_ktype = expr->get_ktype();
+
+    std::vector<llvm::ConstantInt*> case_values(cases.size() - 1);
+    for (size_t i = 0; i < cases.size() - 1; ++i) {
+        auto* value = promoted_trivially_gen(cases[i].cond, compiler, expr_ktype, "match");
+        case_values[i] = llvm::cast<llvm::ConstantInt>(value);
+    }
+
+    auto* match_expr_val = expr->gen();
+    auto* default_bb = compiler.create_basic_block("default");
+    auto* merge_bb = compiler.create_basic_block("merge");
+    auto* switch_inst = builder.CreateSwitch(match_expr_val, default_bb, cases.size() - 1);
+
+    std::vector<std::pair<llvm::Value*, llvm::BasicBlock*>> incoming;
+    incoming.reserve(cases.size());
+    for (size_t i = 0; i < cases.size(); ++i) {
+        auto* case_bb = i < cases.size() - 1 ? compiler.create_basic_block(std::format("case_{}", i)) : default_bb;
+        if (case_bb != default_bb) switch_inst->addCase(case_values[i], case_bb);
+
+        builder.SetInsertPoint(case_bb);
+        auto* case_ret = cases[i].ret->gen();
+        incoming.emplace_back(case_ret, builder.GetInsertBlock());
+        builder.CreateBr(merge_bb);
+    }
+
+    builder.SetInsertPoint(merge_bb);
+    auto* phi = builder.CreatePHI(gen_type(), cases.size());
+    for (const auto& [value, bb] : incoming) {
+        phi->addIncoming(value, bb);
+    }
+
+    return phi;
+}
+
 KType* MatchNode::get_ktype() const
 {
     if (!type) {
@@ -111,15 +168,13 @@ llvm::Type* MatchNode::gen_type() const
     return cases.back().ret->gen_type();
 }
 
-std::vector<ASTNode*> MatchNode::get_children() const
+void MatchNode::for_each_child(ChildCallback fn) const
 {
-    std::vector<ASTNode*> children;
-    children.push_back(expr);
+    fn(expr);
     for (const auto& c : cases) {
-        if (c.cond) children.push_back(c.cond);
-        children.push_back(c.ret);
+        if (c.cond) fn(c.cond);
+        fn(c.ret);
     }
-    return children;
 }
 
 void MatchNode::check_types() const
@@ -133,6 +188,28 @@ void MatchNode::check_types() const
                 case_type->to_string(), cases.back().ret->to_string(), def_type->to_string()));
         }
     }
+
+    check_duplicate_cases();
+}
+
+// Both the switch and the compare chain lowering go through check_types(), so a repeated constant arm is rejected
+// even when other arms are not constant
+void MatchNode::check_duplicate_cases() const
+{
+    std::unordered_set<int64_t> seen_values;
+    for (size_t i = 0; i < cases.size() - 1; i++) {
+        auto* cond = cases[i].cond;
+        if (!cond->is_trivially_evaluable()) continue;
+
+        const auto* cond_ktype = cond->get_ktype();
+        if (!cond_ktype->is_integer() && !cond_ktype->is_char() && !cond_ktype->is_boolean()) continue;
+
+        const auto* value = llvm::cast<llvm::ConstantInt>(cond->trivial_gen());
+        const auto key = cond_ktype->is_boolean() ? static_cast<int64_t>(value->getZExtValue()) : value->getSExtValue();
+        if (!seen_values.insert(key).second) {
+            throw std::runtime_error(std::format("Duplicate case `{}` in match expression", cond->to_string()));
+        }
+    }
 }
 
 void MatchNode::validate_default()
@@ -16,7 +16,8 @@
 #include "llvm/IR/Instructions.h"
 
 MemberAccessNode::MemberAccessNode(ExpressionNode* lhs, std::string member, ModuleCompiler& compiler)
-    : lhs(lhs)
+    : ExpressionNode(Kind::MemberAccessNode)
+    , lhs(lhs)
     , member(std::move(member))
     , compiler(compiler)
 {
@@ -76,8 +77,7 @@ KType* MemberAccessNode::get_ktype() const
     auto* lhs_type = lhs->get_ktype();
 
     if (lhs_type->is_slice()) {
-        static PrimitiveType size_type(PrimitiveType::Kind::I64);
-        if (member == "size") return &size_type;
+        if (member == "size") return compiler.get_type_context().primitive(PrimitiveType::Kind::I64);
         throw std::runtime_error(
             std::format("Slice type `{}` does not have a member with name `{}`", lhs_type->to_string(), member));
     }
@@ -87,7 +87,7 @@ KType* MemberAccessNode::get_ktype() const
     std::string class_name = lhs_type->get_class_name();
     auto& class_metadata = compiler.get_class_metadata(class_name);
 
-    return get_member_declaration(class_metadata)->as<DeclarationStatementNode>()->get_ktype();
+    return get_member_declaration(class_metadata)->get_ktype();
 }
 
 void MemberAccessNode::validate_member_access(KType* lhs_type) const
@@ -120,9 +120,9 @@ unsigned MemberAccessNode::get_member_index(KType* lhs_type) const
     return idx.value();
 }
 
-const ASTNode* MemberAccessNode::get_member_declaration(const ClassMetadata& class_metadata) const
+const DeclarationStatementNode* MemberAccessNode::get_member_declaration(const ClassMetadata& class_metadata) const
 {
-    const auto* member_def = class_metadata.node->get_declaration_of(member);
+    const auto* member_def = class_metadata.get_field(member);
 
     if (!member_def) {
         throw std::runtime_error(
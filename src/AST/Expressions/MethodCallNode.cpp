@@ -10,12 +10,13 @@
 #include "kyoto/AST/Expressions/FunctionCallNode.h"
 #include "kyoto/AST/Expressions/MemberAccessNode.h"
 #include "kyoto/AST/Expressions/UnaryNode.h"
+#include "kyoto/AST/Expressions/VectorReduceNode.h"
 #include "kyoto/KType.h"
 #include "kyoto/ModuleCompiler.h"
 
 MethodCall::MethodCall(ExpressionNode* instance, std::string instance_text, std::string name,
                        std::vector<ExpressionNode*> args, ModuleCompiler& compiler)
-    : FunctionCall(std::move(name), std::move(args), compiler)
+    : FunctionCall(Kind::MethodCall, std::move(name), std::move(args), compiler)
     , instance(instance)
     , instance_text(std::move(instance_text))
 {
@@ -24,6 +25,7 @@ MethodCall::MethodCall(ExpressionNode* instance, std::string instance_text, std:
 MethodCall::~MethodCall()
 {
     if (!prepared) delete instance;
+    delete reduction;
 }
 
 std::string MethodCall::to_string() const
@@ -34,46 +36,50 @@ std::string MethodCall::to_string() const
 llvm::Value* MethodCall::gen()
 {
     prepare_call();
+    if (reduction) return reduction->gen();
     return FunctionCall::gen();
 }
 
 llvm::Value* MethodCall::gen_ptr() const
 {
     prepare_call();
+    if (reduction) return reduction->gen_ptr();
     return FunctionCall::gen_ptr();
 }
 
 llvm::Type* MethodCall::gen_type() const
 {
     prepare_call();
+    if (reduction) return reduction->gen_type();
     return FunctionCall::gen_type();
 }
 
 KType* MethodCall::get_ktype() const
 {
     prepare_call();
+    if (reduction) return reduction->get_ktype();
     return FunctionCall::get_ktype();
 }
 
 llvm::Value* MethodCall::trivial_gen()
 {
     prepare_call();
+    if (reduction) return nullptr;
     return FunctionCall::trivial_gen();
 }
 
 bool MethodCall::is_trivially_evaluable() const
 {
     prepare_call();
+    if (reduction) return false;
     return FunctionCall::is_trivially_evaluable();
 }
 
-std::vector<ASTNode*> MethodCall::get_children() const
+void MethodCall::for_each_child(ChildCallback fn) const
 {
-    auto children = FunctionCall::get_children();
-    if (!prepared && instance) {
-        children.insert(children.begin(), instance);
-    }
-    return children;
+    if (!prepared && instance) fn(instance);
+    if (reduction) fn(reduction);
+    FunctionCall::for_each_child(fn);
 }
 
 void MethodCall::prepare_call() const
@@ -84,19 +90,33 @@ void MethodCall::prepare_call() const
     }
 
     auto* instance_type = instance->get_ktype();
+    if (instance_type->is_vector()) {
+        if (!args.empty()) {
+            throw std::runtime_error(std::format("Vector method `{}` does not take arguments", to_string()));
+        }
+        const_cast<MethodCall*>(this)->reduction = new VectorReduceNode(instance, name, compiler);
+        const_cast<MethodCall*>(this)->instance = nullptr;
+        const_cast<MethodCall*>(this)->prepared = true;
+        return;
+    }
+
     auto class_name = instance_type->get_class_name();
 
     if (compiler.class_exists(class_name)) {
         auto& class_metadata = compiler.get_class_metadata(class_name);
-        if (const auto* member_decl = class_metadata.node->get_declaration_of(name); member_decl) {
-            auto* member_type = member_decl->as<DeclarationStatementNode>()->get_ktype();
-            if (member_type->is_function()) {
+        if (const auto* member_decl = class_metadata.get_field(name); member_decl) {
+            if (member_decl->get_ktype()->is_function()) {
                 const_cast<MethodCall*>(this)->callee = new MemberAccessNode(instance, name, compiler);
                 const_cast<MethodCall*>(this)->instance = nullptr;
                 const_cast<MethodCall*>(this)->prepared = true;
                 return;
             }
         }
+
+        if (!class_metadata.has_method(name)) {
+            throw std::runtime_error(
+                std::format("Class `{}` does not have a method with name `{}`", class_name, name));
+        }
     }
 
     ExpressionNode* self = instance;
@@ -1,58 +1,67 @@
 #include "kyoto/AST/Expressions/NewArrayNode.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <format>
 #include <llvm/ADT/ArrayRef.h>
+#include <llvm/IR/BasicBlock.h>
 #include <llvm/IR/Constants.h>
+#include <llvm/IR/DataLayout.h>
 #include <llvm/IR/DerivedTypes.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/Instructions.h>
+#include <llvm/IR/Intrinsics.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Type.h>
 #include <llvm/IR/Value.h>
-#include <stddef.h>
 #include <stdexcept>
 
+#include "kyoto/AST/ASTNode.h"
+#include "kyoto/ArenaRuntime.h"
 #include "kyoto/KType.h"
 #include "kyoto/ModuleCompiler.h"
+#include "kyoto/RuntimeSupport.h"
 
-NewArrayNode::NewArrayNode(KType* type, ExpressionNode* size_expr, ModuleCompiler& compiler)
-    : type(type)
+NewArrayNode::NewArrayNode(KType* type, ExpressionNode* size_expr, ModuleCompiler& compiler, uint64_t align,
+                           bool zeroed)
+    : ExpressionNode(Kind::NewArrayNode)
+    , type(type)
     , size_expr(size_expr)
+    , align(align)
+    , zeroed(zeroed)
     , compiler(compiler)
 {
     // For heap arrays, new T[n] returns T*, not T[n]
-    generated_type = new PointerType(type->copy());
+    generated_type = compiler.get_type_context().pointer(type);
 }
 
 NewArrayNode::~NewArrayNode()
 {
-    delete generated_type;
     delete size_expr;
 }
 
 std::string NewArrayNode::to_string() const
 {
-    return std::format("new {}[{}]", type->to_string(), size_expr->to_string());
+    const auto align_prefix = align ? std::format("align({}) ", align) : std::string {};
+    return std::format("new {}{}{}[{}]", align_prefix, zeroed ? "zeroed " : "", type->to_string(),
+                       size_expr->to_string());
 }
 
 namespace {
-size_t get_element_size(const KType* type, ModuleCompiler& compiler)
-{
-    if (type->is_primitive()) {
-        return type->as<PrimitiveType>()->width();
-    }
-
-    if (type->is_pointer()) {
-        return compiler.get_module()->getDataLayout().getPointerSize();
-    }
 
-    if (type->is_class()) {
-        return compiler.get_type_size(type->get_class_name());
-    }
+// What malloc and calloc guarantee on the supported targets; stricter alignments go through aligned_alloc.
+constexpr uint64_t malloc_align = 16;
 
-    throw std::runtime_error(std::format("Unsupported type for new array: {}", type->to_string()));
+// calloc(count, size) and aligned_alloc(alignment, size) share one signature.
+llvm::FunctionCallee get_libc_allocator(ModuleCompiler& compiler, const char* name)
+{
+    auto& context = compiler.get_context();
+    auto* i64_type = llvm::Type::getInt64Ty(context);
+    auto* type = llvm::FunctionType::get(llvm::PointerType::get(context, 0), { i64_type, i64_type }, false);
+    return compiler.get_module()->getOrInsertFunction(name, type);
 }
+
 }
 
 llvm::Value* NewArrayNode::gen()
@@ -63,54 +72,60 @@ llvm::Value* NewArrayNode::gen()
             std::format("Array size expression must be of integer type, got: {}", size_type->to_string()));
     }
 
-    llvm::Value* size_value = size_expr->gen();
-
-    size_t element_size = get_element_size(type, compiler);
+    auto& builder = compiler.get_builder();
+    auto* i64_type = builder.getInt64Ty();
+    auto* count = builder.CreateIntCast(size_expr->gen(), i64_type, true, "count");
+
+    // Sizes and alignments come from the DataLayout so that they agree with the GEPs indexing the array.
+    const auto& data_layout = compiler.get_data_layout();
+    auto* element_type = ASTNode::get_llvm_type(type, compiler);
+    const uint64_t element_size = data_layout.getTypeAllocSize(element_type);
+    const uint64_t alignment = std::max(align, data_layout.getABITypeAlign(element_type).value());
+    auto* arena = compiler.get_current_arena();
+    const bool over_aligned = !arena && alignment > malloc_align;
+
+    auto* product
+        = builder.CreateBinaryIntrinsic(llvm::Intrinsic::umul_with_overflow, count, builder.getInt64(element_size));
+    llvm::Value* total_size = builder.CreateExtractValue(product, { 0 }, "total_size");
+    llvm::Value* invalid = builder.CreateOr(builder.CreateExtractValue(product, { 1 }),
+                                            builder.CreateICmpSLT(count, builder.getInt64(0)), "size_invalid");
+    if (over_aligned) {
+        // aligned_alloc takes a multiple of the alignment, and rounding up to it must not wrap either.
+        invalid = builder.CreateOr(invalid, builder.CreateICmpUGT(total_size, builder.getInt64(-alignment)));
+        total_size = builder.CreateAnd(builder.CreateAdd(total_size, builder.getInt64(alignment - 1)),
+                                       builder.getInt64(~(alignment - 1)), "aligned_size");
+    }
 
-    llvm::Value* size_i64;
-    if (size_value->getType()->isIntegerTy(64)) {
-        size_i64 = size_value;
+    auto* fn = builder.GetInsertBlock()->getParent();
+    auto* overflow_bb = llvm::BasicBlock::Create(compiler.get_context(), "new_array_overflow", fn);
+    auto* ok_bb = llvm::BasicBlock::Create(compiler.get_context(), "new_array_size_ok", fn);
+    builder.CreateCondBr(invalid, overflow_bb, ok_bb);
+
+    // Negative or overflowing sizes stop the program instead of allocating a too small block.
+    builder.SetInsertPoint(overflow_bb);
+    gen_runtime_error(compiler, builder, "__kyoto_new_array_overflow", "runtime error: invalid size in new array");
+
+    builder.SetInsertPoint(ok_bb);
+    llvm::Value* ptr;
+    if (arena) {
+        ptr = gen_arena_alloc(compiler, arena, total_size, alignment);
+    } else if (over_aligned) {
+        auto aligned_alloc_fn = get_libc_allocator(compiler, "aligned_alloc");
+        ptr = builder.CreateCall(aligned_alloc_fn, { builder.getInt64(alignment), total_size });
+    } else if (zeroed) {
+        // Large calloc blocks come straight from fresh, already zeroed pages, so nothing has to be written.
+        return builder.CreateCall(get_libc_allocator(compiler, "calloc"), { count, builder.getInt64(element_size) });
     } else {
-        size_i64
-            = compiler.get_builder().CreateIntCast(size_value, llvm::Type::getInt64Ty(compiler.get_context()), true);
+        return builder.CreateCall(compiler.get_module()->getFunction("malloc"), total_size);
     }
 
-    llvm::Value* element_size_value
-        = llvm::ConstantInt::get(llvm::Type::getInt64Ty(compiler.get_context()), element_size);
-    llvm::Value* total_size = compiler.get_builder().CreateMul(size_i64, element_size_value);
-
-    auto* malloc_fn = compiler.get_module()->getFunction("malloc");
-    auto* ptr = compiler.get_builder().CreateCall(malloc_fn, total_size);
+    if (zeroed) builder.CreateMemSet(ptr, builder.getInt8(0), total_size, llvm::MaybeAlign(alignment));
     return ptr;
 }
 
 llvm::Value* NewArrayNode::gen_ptr() const
 {
-    KType* size_type = size_expr->get_ktype();
-    if (!size_type->is_primitive() || !size_type->as<PrimitiveType>()->is_integer()) {
-        throw std::runtime_error(
-            std::format("Array size expression must be of integer type, got: {}", size_type->to_string()));
-    }
-
-    llvm::Value* size_value = size_expr->gen();
-
-    size_t element_size = get_element_size(type, compiler);
-
-    llvm::Value* size_i64;
-    if (size_value->getType()->isIntegerTy(64)) {
-        size_i64 = size_value;
-    } else {
-        size_i64
-            = compiler.get_builder().CreateIntCast(size_value, llvm::Type::getInt64Ty(compiler.get_context()), true);
-    }
-
-    llvm::Value* element_size_value
-        = llvm::ConstantInt::get(llvm::Type::getInt64Ty(compiler.get_context()), element_size);
-    llvm::Value* total_size = compiler.get_builder().CreateMul(size_i64, element_size_value);
-
-    auto* malloc_fn = compiler.get_module()->getFunction("malloc");
-    auto* ptr = compiler.get_builder().CreateCall(malloc_fn, total_size);
-    return ptr;
+    return const_cast<NewArrayNode*>(this)->gen();
 }
 
 llvm::Type* NewArrayNode::gen_type() const
@@ -1,30 +1,38 @@
 #include "kyoto/AST/Expressions/NewNode.h"
 
+#include <cstdint>
 #include <format>
 #include <llvm/ADT/ArrayRef.h>
 #include <llvm/IR/Constants.h>
+#include <llvm/IR/DataLayout.h>
 #include <llvm/IR/DerivedTypes.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/Instructions.h>
+#include <llvm/IR/Metadata.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Type.h>
 
 #include "kyoto/AST/Expressions/FunctionCallNode.h"
+#include "kyoto/Analysis/HeapToStack.h"
+#include "kyoto/ArenaRuntime.h"
+#include "kyoto/CompilerOptions.h"
 #include "kyoto/KType.h"
 #include "kyoto/ModuleCompiler.h"
+#include "kyoto/PoolRuntime.h"
 
 NewNode::NewNode(KType* type, FunctionCall* constructor_call, ModuleCompiler& compiler)
-    : type(type)
+    : ExpressionNode(Kind::NewNode)
+    , type(type)
     , constructor_call(constructor_call)
     , compiler(compiler)
 {
-    generated_type = new PointerType(type);
+    generated_type = compiler.get_type_context().pointer(type);
 }
 
 NewNode::~NewNode()
 {
-    delete generated_type;
+    delete type;
 }
 
 std::string NewNode::to_string() const
@@ -34,12 +42,26 @@ std::string NewNode::to_string() const
 
 llvm::Value* NewNode::gen()
 {
+    auto& context = compiler.get_context();
     const auto& class_name = type->get_class_name();
     const auto& class_size = compiler.get_type_size(class_name);
     auto* malloc_fn = compiler.get_module()->getFunction("malloc");
 
-    llvm::Value* size_arg = llvm::ConstantInt::get(llvm::Type::getInt64Ty(compiler.get_context()), class_size);
-    auto* ptr = compiler.get_builder().CreateCall(malloc_fn, size_arg);
+    llvm::Value* size_arg = llvm::ConstantInt::get(llvm::Type::getInt64Ty(context), class_size);
+    const auto pool_block_size
+        = compiler.get_options().alloc == AllocMode::Pool ? get_pool_block_size(class_size) : uint64_t { 0 };
+    llvm::Value* ptr;
+    if (auto* arena = compiler.get_current_arena()) {
+        const auto align = compiler.get_data_layout().getABITypeAlign(compiler.get_llvm_struct(class_name)).value();
+        ptr = gen_arena_alloc(compiler, arena, size_arg, align);
+    } else {
+        auto* call = pool_block_size ? llvm::cast<llvm::CallInst>(gen_pool_alloc(compiler, pool_block_size))
+                                     : compiler.get_builder().CreateCall(malloc_fn, size_arg);
+        // Lets HeapToStackPass tell `new` apart from calls to malloc made by the program itself.
+        auto* class_name_md = llvm::MDString::get(context, class_name);
+        call->setMetadata(new_allocation_metadata, llvm::MDNode::get(context, class_name_md));
+        ptr = call;
+    }
     constructor_call->set_destination(ptr);
 
     constructor_call->gen();
@@ -48,16 +70,7 @@ llvm::Value* NewNode::gen()
 
 llvm::Value* NewNode::gen_ptr() const
 {
-    const auto& class_name = type->get_class_name();
-    const auto& class_size = compiler.get_type_size(class_name);
-    auto* malloc_fn = compiler.get_module()->getFunction("malloc");
-
-    llvm::Value* size_arg = llvm::ConstantInt::get(llvm::Type::getInt64Ty(compiler.get_context()), class_size);
-    auto* ptr = compiler.get_builder().CreateCall(malloc_fn, size_arg);
-    constructor_call->set_destination(ptr);
-
-    constructor_call->gen();
-    return ptr;
+    return const_cast<NewNode*>(this)->gen();
 }
 
 llvm::Type* NewNode::gen_type() const
@@ -10,7 +10,8 @@
 #include "llvm/IR/Constants.h"
 
 NumberNode::NumberNode(int64_t value, KType* ktype, ModuleCompiler& compiler)
-    : value(value)
+    : ExpressionNode(Kind::NumberNode)
+    , value(value)
     , type(ktype)
     , compiler(compiler)
 {
@@ -29,7 +30,7 @@ std::string NumberNode::to_string() const
 llvm::Value* NumberNode::gen()
 {
     if (!type->is_primitive()) throw std::runtime_error("NumberNode type must be a primitive type");
-    const auto primitive_type = dynamic_cast<PrimitiveType*>(type);
+    const auto primitive_type = type->as<PrimitiveType>();
     size_t width = primitive_type->width();
     auto b = primitive_type->is_boolean();
     return llvm::ConstantInt::get(compiler.get_context(), llvm::APInt(b ? 1 : width * 8, value, b ? false : true));
@@ -48,7 +49,7 @@ bool NumberNode::is_trivially_evaluable() const
 llvm::Value* NumberNode::trivial_gen()
 {
     if (!type->is_primitive()) throw std::runtime_error("NumberNode type must be a primitive type");
-    auto primitive_type = dynamic_cast<PrimitiveType*>(type);
+    auto primitive_type = type->as<PrimitiveType>();
     return llvm::ConstantInt::get(compiler.get_context(), llvm::APInt(64, value, true));
 }
 
@@ -59,7 +60,6 @@ KType* NumberNode::get_ktype() const
 
 void NumberNode::cast_to(PrimitiveType::Kind target_kind)
 {
-    const auto target_type = new PrimitiveType(target_kind);
     delete type;
-    type = target_type;
+    type = compiler.get_type_context().primitive(target_kind);
 }
\ No newline at end of file
@@ -12,9 +12,11 @@
 #include "kyoto/ModuleCompiler.h"
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/Type.h"
+#include "llvm/Support/Casting.h"
 
 SizeofNode::SizeofNode(ExpressionNode* expr, ModuleCompiler& compiler)
-    : operand_type(OperandType::Expression)
+    : ExpressionNode(Kind::SizeofNode)
+    , operand_type(OperandType::Expression)
     , expr(expr)
     , type(nullptr)
     , compiler(compiler)
@@ -22,7 +24,8 @@ SizeofNode::SizeofNode(ExpressionNode* expr, ModuleCompiler& compiler)
 }
 
 SizeofNode::SizeofNode(KType* type, ModuleCompiler& compiler)
-    : operand_type(OperandType::Type)
+    : ExpressionNode(Kind::SizeofNode)
+    , operand_type(OperandType::Type)
     , expr(nullptr)
     , type(type)
     , compiler(compiler)
@@ -56,7 +59,7 @@ llvm::Value* SizeofNode::gen()
     if (operand_type == OperandType::Expression) {
         // Special case: if the expression is an identifier that refers to a class name,
         // treat it as a class type instead of trying to look it up as a variable
-        auto* identifier_expr = dynamic_cast<IdentifierExpressionNode*>(expr);
+        auto* identifier_expr = llvm::dyn_cast<IdentifierExpressionNode>(expr);
         const auto local_class_name
             = identifier_expr ? compiler.qualify_local_name(identifier_expr->get_name()) : std::string {};
         if (identifier_expr && compiler.class_exists(local_class_name)) {
@@ -95,6 +98,8 @@ llvm::Value* SizeofNode::gen()
         size_bytes = element_size * array_type->get_size();
     } else if (target_type->is_class()) {
         size_bytes = compiler.get_type_size(target_type->get_class_name());
+    } else if (target_type->is_vector()) {
+        size_bytes = compiler.get_data_layout().getTypeAllocSize(get_llvm_type(target_type, compiler));
     } else {
         throw std::runtime_error("Unsupported type in sizeof expression");
     }
@@ -118,7 +123,7 @@ llvm::Type* SizeofNode::gen_type() const
 
 KType* SizeofNode::get_ktype() const
 {
-    return new PrimitiveType(PrimitiveType::Kind::I32);
+    return compiler.get_type_context().primitive(PrimitiveType::Kind::I32);
 }
 
 llvm::Value* SizeofNode::trivial_gen()
@@ -131,10 +136,7 @@ bool SizeofNode::is_trivially_evaluable() const
     return true;
 }
 
-std::vector<ASTNode*> SizeofNode::get_children() const
+void SizeofNode::for_each_child(ChildCallback fn) const
 {
-    if (operand_type == OperandType::Expression && expr) {
-        return { expr };
-    }
-    return {};
+    if (operand_type == OperandType::Expression && expr) fn(expr);
 }
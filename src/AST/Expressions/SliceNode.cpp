@@ -11,7 +11,8 @@
 #include "llvm/IR/Type.h"
 
 SliceNode::SliceNode(ExpressionNode* ptr, ExpressionNode* size, ModuleCompiler& compiler)
-    : ptr(ptr)
+    : ExpressionNode(Kind::SliceNode)
+    , ptr(ptr)
     , size(size)
     , compiler(compiler)
 {
@@ -21,7 +22,6 @@ SliceNode::~SliceNode()
 {
     delete ptr;
     delete size;
-    delete cached_type;
 }
 
 std::string SliceNode::to_string() const
@@ -53,7 +53,7 @@ KType* SliceNode::get_ktype() const
 {
     validate();
     if (!cached_type) {
-        cached_type = new SliceType(ptr->get_ktype()->as<PointerType>()->get_pointee()->copy());
+        cached_type = compiler.get_type_context().slice(ptr->get_ktype()->as<PointerType>()->get_pointee());
     }
     return cached_type;
 }
@@ -68,9 +68,10 @@ bool SliceNode::is_trivially_evaluable() const
     return false;
 }
 
-std::vector<ASTNode*> SliceNode::get_children() const
+void SliceNode::for_each_child(ChildCallback fn) const
 {
-    return { ptr, size };
+    fn(ptr);
+    fn(size);
 }
 
 void SliceNode::validate() const
@@ -10,16 +10,14 @@
 #include "llvm/IR/IRBuilder.h"
 
 StringLiteralNode::StringLiteralNode(std::string value, ModuleCompiler& compiler)
-    : type(nullptr)
+    : ExpressionNode(Kind::StringLiteralNode)
+    , type(nullptr)
     , value(std::move(value))
     , compiler(compiler)
 {
 }
 
-StringLiteralNode::~StringLiteralNode()
-{
-    delete type;
-}
+StringLiteralNode::~StringLiteralNode() = default;
 
 std::string StringLiteralNode::to_string() const
 {
@@ -29,8 +27,7 @@ std::string StringLiteralNode::to_string() const
 
 llvm::Value* StringLiteralNode::gen()
 {
-    auto str = compiler.get_builder().CreateGlobalString(value.data());
-    return str;
+    return compiler.get_string_constant(value.data());
 }
 
 llvm::Type* StringLiteralNode::gen_type() const
@@ -51,7 +48,8 @@ bool StringLiteralNode::is_trivially_evaluable() const
 KType* StringLiteralNode::get_ktype() const
 {
     if (!type) {
-        type = new PointerType(new PrimitiveType(PrimitiveType::Kind::Char));
+        auto& types = compiler.get_type_context();
+        type = types.pointer(types.primitive(PrimitiveType::Kind::Char));
     }
     return type;
 }
\ No newline at end of file
@@ -18,7 +18,8 @@ class Value;
 }
 
 UnaryNode::UnaryNode(ExpressionNode* expr, UnaryOp op, ModuleCompiler& compiler)
-    : type(nullptr)
+    : ExpressionNode(Kind::UnaryNode)
+    , type(nullptr)
     , expr(expr)
     , op(op)
     , compiler(compiler)
@@ -27,8 +28,6 @@ UnaryNode::UnaryNode(ExpressionNode* expr, UnaryOp op, ModuleCompiler& compiler)
 
 UnaryNode::~UnaryNode()
 {
-    // We only delete the pointer wrapper without deleting the type itself
-    if (op == UnaryOp::AddressOf) operator delete(type);
     delete expr;
 }
 
@@ -41,6 +40,9 @@ llvm::Value* UnaryNode::gen()
 {
     auto* expr_val = expr->gen();
 
+    if (op == UnaryOp::Negate && expr_val->getType()->isFPOrFPVectorTy()) {
+        return compiler.get_builder().CreateFNeg(expr_val, "negval");
+    }
     if (op == UnaryOp::Negate) return compiler.get_builder().CreateNeg(expr_val, "negval");
     if (op == UnaryOp::Positive) return expr_val;
     if (op == UnaryOp::LogicalNot) return gen_logical_not();
@@ -88,7 +90,7 @@ llvm::Value* UnaryNode::gen_ptr() const
 KType* UnaryNode::get_ktype() const
 {
     if (op == UnaryOp::AddressOf) {
-        if (!type) type = new PointerType(expr->get_ktype());
+        if (!type) type = compiler.get_type_context().pointer(expr->get_ktype());
         return type;
     }
     if (op == UnaryOp::Dereference) {
@@ -0,0 +1,83 @@
+#include "kyoto/AST/Expressions/VectorReduceNode.h"
+
+#include <format>
+#include <stdexcept>
+#include <utility>
+
+#include "kyoto/AST/ASTNode.h"
+#include "kyoto/KType.h"
+#include "kyoto/ModuleCompiler.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/IRBuilder.h"
+
+VectorReduceNode::VectorReduceNode(ExpressionNode* vector, std::string op, ModuleCompiler& compiler)
+    : ExpressionNode(Kind::VectorReduceNode)
+    , vector(vector)
+    , op(std::move(op))
+    , compiler(compiler)
+{
+}
+
+VectorReduceNode::~VectorReduceNode()
+{
+    delete vector;
+}
+
+std::string VectorReduceNode::to_string() const
+{
+    return std::format("{}.{}()", vector->to_string(), op);
+}
+
+llvm::Value* VectorReduceNode::gen()
+{
+    const auto* element_type = get_vector_type()->get_element_type();
+    auto& builder = compiler.get_builder();
+    auto* value = vector->gen();
+
+    if (element_type->is_boolean()) {
+        if (op == "any") return builder.CreateOrReduce(value);
+        return builder.CreateAndReduce(value);
+    }
+
+    if (element_type->is_floating_point()) {
+        // Without reassociation the float reductions are ordered, so they round exactly like a scalar loop would.
+        auto* llvm_element_type = get_llvm_type(element_type, compiler);
+        if (op == "sum") return builder.CreateFAddReduce(llvm::ConstantFP::getNegativeZero(llvm_element_type), value);
+        if (op == "product") return builder.CreateFMulReduce(llvm::ConstantFP::get(llvm_element_type, 1.0), value);
+        if (op == "min") return builder.CreateFPMinReduce(value);
+        return builder.CreateFPMaxReduce(value);
+    }
+
+    if (op == "sum") return builder.CreateAddReduce(value);
+    if (op == "product") return builder.CreateMulReduce(value);
+    if (op == "min") return builder.CreateIntMinReduce(value, true);
+    return builder.CreateIntMaxReduce(value, true);
+}
+
+llvm::Value* VectorReduceNode::gen_ptr() const
+{
+    throw std::runtime_error(std::format("Cannot take address of vector reduction `{}`", to_string()));
+}
+
+llvm::Type* VectorReduceNode::gen_type() const
+{
+    return get_llvm_type(get_vector_type()->get_element_type(), compiler);
+}
+
+KType* VectorReduceNode::get_ktype() const
+{
+    return compiler.get_type_context().intern(get_vector_type()->get_element_type());
+}
+
+const VectorType* VectorReduceNode::get_vector_type() const
+{
+    const auto* vector_type = vector->get_ktype()->as<VectorType>();
+    const bool is_mask = vector_type->get_element_type()->is_boolean();
+    const bool valid = is_mask ? op == "any" || op == "all"
+                               : op == "sum" || op == "product" || op == "min" || op == "max";
+    if (!valid) {
+        throw std::runtime_error(std::format("Vector type `{}` does not have a method with name `{}`",
+                                             vector_type->to_string(), op));
+    }
+    return vector_type;
+}
@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "kyoto/AST/Expressions/ExpressionNode.h"
+#include "kyoto/Analysis/BoundsCheckElimination.h"
 #include "kyoto/KType.h"
 #include "kyoto/ModuleCompiler.h"
 #include "llvm/IR/Constants.h"
@@ -13,7 +14,8 @@
 
 ForStatementNode::ForStatementNode(ASTNode* init, ExpressionStatementNode* condition, ExpressionNode* update,
                                    ASTNode* body, ModuleCompiler& compiler)
-    : init(init)
+    : ASTNode(Kind::ForStatementNode)
+    , init(init)
     , condition(condition)
     , update(update)
     , body(body)
@@ -50,7 +52,10 @@ llvm::Value* ForStatementNode::gen()
     handle_condition(cond_bb, body_bb, out_bb);
 
     compiler.get_builder().SetInsertPoint(body_bb);
+    auto slice_fact = analyze_slice_induction(*this, compiler);
+    if (slice_fact) compiler.push_slice_index_fact(*slice_fact);
     body->gen();
+    if (slice_fact) compiler.pop_slice_index_fact();
 
     handle_update(update_bb, cond_bb, body_bb);
 
@@ -121,7 +126,10 @@ void ForStatementNode::handle_update(llvm::BasicBlock* update_bb, llvm::BasicBlo
     compiler.get_builder().CreateBr(cond_bb);
 }
 
-std::vector<ASTNode*> ForStatementNode::get_children() const
+void ForStatementNode::for_each_child(ChildCallback fn) const
 {
-    return { init, condition, update, body };
+    if (init) fn(init);
+    if (condition) fn(condition);
+    if (update) fn(update);
+    if (body) fn(body);
 }
\ No newline at end of file
@@ -9,10 +9,14 @@
 #include <vector>
 
 #include "kyoto/AST/Expressions/ExpressionNode.h"
+#include "kyoto/CompilerOptions.h"
 #include "kyoto/ModuleCompiler.h"
+#include "kyoto/PoolRuntime.h"
+#include "kyoto/KType.h"
 
 FreeStatementNode::FreeStatementNode(ExpressionNode* expr, ModuleCompiler& compiler)
-    : expr(expr)
+    : ASTNode(Kind::FreeStatementNode)
+    , expr(expr)
     , compiler(compiler)
 {
 }
@@ -30,11 +34,24 @@ std::string FreeStatementNode::to_string() const
 llvm::Value* FreeStatementNode::gen()
 {
     auto* ptr = expr->gen();
+    if (compiler.get_options().alloc == AllocMode::Pool) {
+        // Only the pointer's static type tells how large the block is, so pointers to classes are pooled and anything
+        // else (notably arrays, whose element count is unknown here) goes through libc's free.
+        const auto* type = expr->get_ktype();
+        if (type && type->is_pointer() && type->as<PointerType>()->get_pointee()->is_class()) {
+            const auto& class_name = type->as<PointerType>()->get_pointee()->get_class_name();
+            if (const auto block_size = get_pool_block_size(compiler.get_type_size(class_name))) {
+                gen_pool_free(compiler, ptr, block_size);
+                return nullptr;
+            }
+        }
+    }
+
     auto* free_fn = compiler.get_module()->getFunction("free");
     return compiler.get_builder().CreateCall(free_fn, ptr);
 }
 
-std::vector<ASTNode*> FreeStatementNode::get_children() const
+void FreeStatementNode::for_each_child(ChildCallback fn) const
 {
-    return { expr };
+    fn(expr);
 }
\ No newline at end of file
@@ -14,7 +14,8 @@
 
 IfStatementNode::IfStatementNode(std::vector<ExpressionNode*> conditions, std::vector<ASTNode*> bodies,
                                  ModuleCompiler& compiler)
-    : conditions(std::move(conditions))
+    : ASTNode(Kind::IfStatementNode)
+    , conditions(std::move(conditions))
     , bodies(std::move(bodies))
     , compiler(compiler)
 {
@@ -99,17 +100,12 @@ llvm::Value* IfStatementNode::gen()
     return nullptr;
 }
 
-std::vector<ASTNode*> IfStatementNode::get_children() const
+void IfStatementNode::for_each_child(ChildCallback fn) const
 {
-    std::vector<ASTNode*> children;
-    children.reserve(conditions.size() + bodies.size());
-
     for (size_t i = 0; i < conditions.size(); ++i) {
-        children.push_back(conditions[i]);
-        children.push_back(bodies[i]);
+        fn(conditions[i]);
+        fn(bodies[i]);
     }
 
-    if (has_else()) children.push_back(bodies.back());
-
-    return children;
+    if (has_else()) fn(bodies.back());
 }
\ No newline at end of file
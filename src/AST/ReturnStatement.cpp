@@ -9,6 +9,7 @@
 
 #include "kyoto/AST/ASTNode.h"
 #include "kyoto/AST/Expressions/ExpressionNode.h"
+#include "kyoto/ArenaRuntime.h"
 #include "kyoto/KType.h"
 #include "kyoto/ModuleCompiler.h"
 
@@ -17,7 +18,8 @@ class Value;
 }
 
 ReturnStatementNode::ReturnStatementNode(ExpressionNode* expr, ModuleCompiler& compiler)
-    : expr(expr)
+    : ASTNode(Kind::ReturnStatementNode)
+    , expr(expr)
     , compiler(compiler)
 {
 }
@@ -38,6 +40,7 @@ llvm::Value* ReturnStatementNode::gen()
 
     if (fn_ret_type->is_void()) {
         validate_void_return();
+        release_arenas();
         return compiler.get_builder().CreateRetVoid();
     }
 
@@ -45,10 +48,19 @@ llvm::Value* ReturnStatementNode::gen()
         throw std::runtime_error(std::format("Expected return type `{}`", fn_ret_type->to_string()));
     }
 
+    // The value may still be read out of an arena object, so it is computed before the arenas go away.
     llvm::Value* expr_val = generate_return_value();
+    release_arenas();
     return compiler.get_builder().CreateRet(expr_val);
 }
 
+void ReturnStatementNode::release_arenas() const
+{
+    for (auto* arena : compiler.get_function_arenas()) {
+        gen_arena_release(compiler, arena);
+    }
+}
+
 void ReturnStatementNode::validate_void_return() const
 {
     if (expr) {
@@ -78,6 +90,10 @@ llvm::Value* ReturnStatementNode::generate_return_value() const
         return expr->gen();
     }
 
+    if (fn_ret_type->is_vector() && expr->get_ktype()->is_vector() && fn_ret_type->operator==(*expr->get_ktype())) {
+        return expr->gen();
+    }
+
     if (ExpressionNode::can_convert_array_to_slice(fn_ret_type, expr->get_ktype())) {
         return ExpressionNode::convert_array_to_slice(expr, fn_ret_type, compiler);
     }
@@ -108,7 +124,7 @@ llvm::Value* ReturnStatementNode::generate_pointer_return_value() const
     return expr_val;
 }
 
-std::vector<ASTNode*> ReturnStatementNode::get_children() const
+void ReturnStatementNode::for_each_child(ChildCallback fn) const
 {
-    return { expr };
+    if (expr) fn(expr);
 }
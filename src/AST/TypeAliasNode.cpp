@@ -6,7 +6,8 @@
 #include "kyoto/ModuleCompiler.h"
 
 TypeAliasNode::TypeAliasNode(KType* originalType, std::string alias, ModuleCompiler& compiler)
-    : originalType(originalType)
+    : ASTNode(Kind::TypeAliasNode)
+    , originalType(originalType)
     , alias(std::move(alias))
     , compiler(compiler)
 {
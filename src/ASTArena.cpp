@@ -0,0 +1,12 @@
+#include "kyoto/ASTArena.h"
+
+#include <ranges>
+
+ASTArena::~ASTArena()
+{
+    // Children are built before the parents that own them, so tearing down in reverse runs each parent's destructor
+    // while the children it `delete`s are still alive; those deletes are no-ops and the slabs go back in one piece.
+    for (const auto& [object, destroy] : std::views::reverse(destructors)) {
+        destroy(object);
+    }
+}
@@ -0,0 +1,166 @@
+#include "kyoto/Analysis/BoundsCheckElimination.h"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "kyoto/AST/ASTNode.h"
+#include "kyoto/AST/DeclarationNodes.h"
+#include "kyoto/AST/Expressions/AssignmentNode.h"
+#include "kyoto/AST/Expressions/BinaryNode.h"
+#include "kyoto/AST/Expressions/ExpressionNode.h"
+#include "kyoto/AST/Expressions/IdentifierNode.h"
+#include "kyoto/AST/Expressions/MemberAccessNode.h"
+#include "kyoto/AST/Expressions/UnaryNode.h"
+#include "kyoto/AST/ForStatementNode.h"
+#include "kyoto/KType.h"
+#include "kyoto/ModuleCompiler.h"
+#include "kyoto/SymbolTable.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/Support/Casting.h"
+
+namespace {
+
+const std::string* identifier_name(ASTNode* node)
+{
+    if (!node) return nullptr;
+    auto* identifier = node->as<IdentifierExpressionNode>();
+    return identifier ? &identifier->get_name() : nullptr;
+}
+
+bool is_identifier(ASTNode* node, const std::string& name)
+{
+    const auto* identifier = identifier_name(node);
+    return identifier && *identifier == name;
+}
+
+bool is_constant_one(ExpressionNode* expr)
+{
+    if (!expr || !expr->is_trivially_evaluable()) return false;
+    auto* value = llvm::dyn_cast_or_null<llvm::ConstantInt>(expr->trivial_gen());
+    return value && value->isOne();
+}
+
+// `++i` or `i = i + 1`
+bool is_unit_increment(ExpressionNode* update, const std::string& index)
+{
+    if (!update) return false;
+
+    if (auto* unary = update->as<UnaryNode>()) {
+        return unary->get_op() == UnaryNode::UnaryOp::PrefixIncrement && is_identifier(unary->get_expr(), index);
+    }
+
+    auto* assignment = update->as<AssignmentNode>();
+    if (!assignment || !is_identifier(assignment->get_assignee(), index)) return false;
+
+    auto* add = assignment->get_expr()->as<AddNode>();
+    if (!add) return false;
+    return (is_identifier(add->get_lhs(), index) && is_constant_one(add->get_rhs()))
+        || (is_constant_one(add->get_lhs()) && is_identifier(add->get_rhs(), index));
+}
+
+// Conservatively reports whether `node` may write to, take the address of or shadow either variable.
+bool may_modify(ASTNode* node, const std::string& index, const std::string& slice)
+{
+    if (!node) return false;
+
+    auto is_tracked_name = [&](const std::string& name) { return name == index || name == slice; };
+    auto is_tracked = [&](ASTNode* expr) {
+        const auto* name = identifier_name(expr);
+        return name && is_tracked_name(*name);
+    };
+
+    if (auto* assignment = node->as<AssignmentNode>(); assignment && is_tracked(assignment->get_assignee())) {
+        return true;
+    }
+
+    if (auto* unary = node->as<UnaryNode>()) {
+        auto op = unary->get_op();
+        bool writes = op == UnaryNode::UnaryOp::PrefixIncrement || op == UnaryNode::UnaryOp::PrefixDecrement
+            || op == UnaryNode::UnaryOp::AddressOf;
+        if (writes && is_tracked(unary->get_expr())) return true;
+    }
+
+    if (auto* decl = node->as<FullDeclarationStatementNode>(); decl && is_tracked_name(decl->get_name())) return true;
+    if (auto* decl = node->as<DeclarationStatementNode>(); decl && is_tracked_name(decl->get_name())) return true;
+
+    bool modifies = false;
+    node->for_each_child([&](ASTNode* child) {
+        if (!modifies) modifies = may_modify(child, index, slice);
+    });
+    return modifies;
+}
+
+// Reports whether an `&` anywhere in `node` applies to either variable. A pointer taken after the loop still reaches
+// the body on the next iteration of an enclosing loop, so this must look at the whole function.
+bool takes_address(ASTNode* node, const std::string& index, const std::string& slice)
+{
+    bool found = false;
+    node->for_each_child([&](ASTNode* child) {
+        if (found) return;
+        if (auto* unary = child->as<UnaryNode>(); unary && unary->get_op() == UnaryNode::UnaryOp::AddressOf) {
+            const auto* name = identifier_name(unary->get_expr());
+            found = name && (*name == index || *name == slice);
+        }
+        if (!found) found = takes_address(child, index, slice);
+    });
+    return found;
+}
+
+// The stack slot must only ever be loaded from or stored to directly; anything else means a pointer to it escaped
+// while generating the code before the loop.
+bool is_private_slot(llvm::AllocaInst* alloca, llvm::Function* fn)
+{
+    if (!alloca || alloca->getFunction() != fn) return false;
+
+    for (auto* user : alloca->users()) {
+        if (llvm::isa<llvm::LoadInst>(user)) continue;
+        auto* store = llvm::dyn_cast<llvm::StoreInst>(user);
+        if (!store || store->getPointerOperand() != alloca) return false;
+    }
+    return true;
+}
+
+}
+
+std::optional<SliceIndexFact> analyze_slice_induction(const ForStatementNode& loop, ModuleCompiler& compiler)
+{
+    auto* init = loop.get_init() ? loop.get_init()->as<FullDeclarationStatementNode>() : nullptr;
+    if (!init || !loop.get_condition()) return std::nullopt;
+
+    const auto index = init->get_name();
+    auto* start = init->get_expression();
+    if (!start || !start->is_trivially_evaluable()) return std::nullopt;
+    auto* start_value = llvm::dyn_cast_or_null<llvm::ConstantInt>(start->trivial_gen());
+    if (!start_value || start_value->isNegative()) return std::nullopt;
+
+    auto* less = loop.get_condition()->get_expr()->as<LessNode>();
+    if (!less || !is_identifier(less->get_lhs(), index)) return std::nullopt;
+
+    auto* size_access = less->get_rhs()->as<MemberAccessNode>();
+    if (!size_access || size_access->get_member() != "size") return std::nullopt;
+    auto* slice_id = size_access->get_lhs()->as<IdentifierExpressionNode>();
+    if (!slice_id || slice_id->get_name() == index) return std::nullopt;
+    const auto& slice = slice_id->get_name();
+
+    if (!is_unit_increment(loop.get_update(), index)) return std::nullopt;
+    if (may_modify(loop.get_body(), index, slice)) return std::nullopt;
+
+    auto* function = compiler.get_current_function_node();
+    if (!function || takes_address(function, index, slice)) return std::nullopt;
+
+    auto index_symbol = compiler.get_symbol(init->get_symbol_id());
+    auto slice_symbol = compiler.get_symbol(slice_id->get_symbol_id());
+    if (!index_symbol || !slice_symbol) return std::nullopt;
+    if (!index_symbol->type->is_integer() || !slice_symbol->type->is_slice()) return std::nullopt;
+
+    auto* fn = compiler.get_builder().GetInsertBlock()->getParent();
+    if (!is_private_slot(index_symbol->alloc, fn) || !is_private_slot(slice_symbol->alloc, fn)) return std::nullopt;
+
+    // Narrower induction variables can wrap past their maximum before reaching a large size.
+    bool non_negative = index_symbol->type->as<PrimitiveType>()->get_kind() == PrimitiveType::Kind::I64;
+
+    return SliceIndexFact { index_symbol->alloc, slice_symbol->alloc, non_negative };
+}
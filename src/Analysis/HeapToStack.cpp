@@ -0,0 +1,194 @@
+#include "kyoto/Analysis/HeapToStack.h"
+
+#include <cstdint>
+#include <format>
+#include <string>
+#include <vector>
+
+#include "kyoto/CompilerOptions.h"
+#include "kyoto/ModuleCompiler.h"
+#include "kyoto/PoolRuntime.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/IR/BasicBlock.h"
+#include "llvm/IR/CFG.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/Metadata.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/Casting.h"
+
+namespace {
+
+// Kyoto spills every pointer variable to a stack slot, so a pointer kept in a local is stored to an alloca that is
+// otherwise only loaded from and stored to.
+bool is_pointer_slot(llvm::AllocaInst* slot)
+{
+    if (!slot->getAllocatedType()->isPointerTy()) return false;
+
+    for (auto* user : slot->users()) {
+        if (llvm::isa<llvm::LoadInst>(user)) continue;
+        auto* store = llvm::dyn_cast<llvm::StoreInst>(user);
+        if (!store || store->getPointerOperand() != slot) return false;
+    }
+    return true;
+}
+
+bool is_in_cycle(llvm::BasicBlock* block)
+{
+    llvm::SmallPtrSet<llvm::BasicBlock*, 16> seen;
+    llvm::SmallVector<llvm::BasicBlock*, 16> worklist(llvm::successors(block));
+    while (!worklist.empty()) {
+        auto* current = worklist.pop_back_val();
+        if (current == block) return true;
+        if (!seen.insert(current).second) continue;
+        worklist.append(llvm::succ_begin(current), llvm::succ_end(current));
+    }
+    return false;
+}
+
+class EscapeAnalysis {
+public:
+    explicit EscapeAnalysis(llvm::Function* free_fn, llvm::Function* pool_free_fn)
+        : free_fn(free_fn)
+        , pool_free_fn(pool_free_fn)
+    {
+    }
+
+    // Follows `root` through field addresses, private pointer slots and calls to functions of the module. Calls to
+    // `free` (or its pool counterpart) on it are collected into `frees` when given and count as an escape otherwise.
+    bool may_escape(llvm::Value* root, std::vector<llvm::CallInst*>* frees)
+    {
+        llvm::SmallPtrSet<llvm::Value*, 16> aliases;
+        llvm::SmallVector<llvm::Value*, 16> worklist;
+        llvm::SmallPtrSet<llvm::AllocaInst*, 4> slots;
+        auto track = [&](llvm::Value* value) {
+            if (aliases.insert(value).second) worklist.push_back(value);
+        };
+        track(root);
+
+        while (!worklist.empty()) {
+            auto* value = worklist.pop_back_val();
+            for (auto& use : value->uses()) {
+                auto* user = use.getUser();
+                if (llvm::isa<llvm::LoadInst>(user) || llvm::isa<llvm::ICmpInst>(user)) continue;
+
+                if (auto* gep = llvm::dyn_cast<llvm::GetElementPtrInst>(user)) {
+                    if (gep->getPointerOperand() != value) return true;
+                    track(gep);
+                    continue;
+                }
+
+                if (auto* store = llvm::dyn_cast<llvm::StoreInst>(user)) {
+                    if (use.getOperandNo() == store->getPointerOperandIndex()) continue;
+                    auto* slot = llvm::dyn_cast<llvm::AllocaInst>(store->getPointerOperand());
+                    if (!slot || !is_pointer_slot(slot)) return true;
+                    if (!slots.insert(slot).second) continue;
+                    for (auto* slot_user : slot->users()) {
+                        if (auto* load = llvm::dyn_cast<llvm::LoadInst>(slot_user)) track(load);
+                    }
+                    continue;
+                }
+
+                auto* call = llvm::dyn_cast<llvm::CallInst>(user);
+                if (!call || !call->isArgOperand(&use)) return true;
+                if (llvm::isa<llvm::MemIntrinsic>(call)) continue;
+
+                auto* callee = call->getCalledFunction();
+                if (callee && (callee == free_fn || callee == pool_free_fn)) {
+                    if (!frees) return true;
+                    frees->push_back(call);
+                    continue;
+                }
+
+                if (!callee || callee->isDeclaration() || callee->isVarArg()) return true;
+                if (argument_may_escape(callee->getArg(call->getArgOperandNo(&use)))) return true;
+            }
+        }
+
+        // The slots only hold this object if nothing else is ever stored into them.
+        for (auto* slot : slots) {
+            for (auto* user : slot->users()) {
+                auto* store = llvm::dyn_cast<llvm::StoreInst>(user);
+                if (store && !aliases.contains(store->getValueOperand())) return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    bool argument_may_escape(llvm::Argument* argument)
+    {
+        if (auto it = argument_escapes.find(argument); it != argument_escapes.end()) return it->second;
+
+        // Recursive calls see the argument as escaping until its own summary is known.
+        argument_escapes[argument] = true;
+        const bool escapes = may_escape(argument, nullptr);
+        argument_escapes[argument] = escapes;
+        return escapes;
+    }
+
+    llvm::Function* free_fn;
+    llvm::Function* pool_free_fn;
+    llvm::DenseMap<const llvm::Argument*, bool> argument_escapes;
+};
+
+}
+
+HeapToStackPass::HeapToStackPass(ModuleCompiler& compiler)
+    : compiler(compiler)
+{
+}
+
+llvm::PreservedAnalyses HeapToStackPass::run(llvm::Module& module, llvm::ModuleAnalysisManager&)
+{
+    EscapeAnalysis escapes(module.getFunction("free"), module.getFunction(pool_free_function));
+    bool changed = false;
+
+    for (auto& fn : module) {
+        if (fn.isDeclaration()) continue;
+
+        std::vector<llvm::CallInst*> allocations;
+        for (auto& inst : llvm::instructions(fn)) {
+            auto* call = llvm::dyn_cast<llvm::CallInst>(&inst);
+            if (call && call->getMetadata(new_allocation_metadata)) allocations.push_back(call);
+        }
+
+        for (auto* allocation : allocations) {
+            auto* size = llvm::dyn_cast<llvm::ConstantInt>(allocation->getArgOperand(0));
+            if (!size || size->getZExtValue() > max_stack_bytes || is_in_cycle(allocation->getParent())) continue;
+
+            std::vector<llvm::CallInst*> frees;
+            if (escapes.may_escape(allocation, &frees)) continue;
+
+            const auto* metadata = allocation->getMetadata(new_allocation_metadata);
+            const auto class_name = llvm::cast<llvm::MDString>(metadata->getOperand(0))->getString().str();
+            const auto bytes = size->getZExtValue();
+
+            auto& entry = fn.getEntryBlock();
+            llvm::IRBuilder<> builder(&entry, entry.getFirstInsertionPt());
+            auto* alloca = builder.CreateAlloca(llvm::ArrayType::get(builder.getInt8Ty(), bytes), nullptr, class_name);
+            // The same alignment malloc guarantees, which the class layout may rely on.
+            alloca->setAlignment(llvm::Align(16));
+
+            allocation->replaceAllUsesWith(alloca);
+            allocation->eraseFromParent();
+            for (auto* free_call : frees) {
+                free_call->eraseFromParent();
+            }
+            changed = true;
+
+            compiler.remark(std::format("{}: `new {}` does not escape, moved its {} bytes to the stack{}",
+                                        fn.getName().str(), class_name, bytes,
+                                        frees.empty() ? "" : std::format(" and removed {} `free`", frees.size())));
+        }
+    }
+
+    return changed ? llvm::PreservedAnalyses::none() : llvm::PreservedAnalyses::all();
+}
@@ -0,0 +1,186 @@
+#include "kyoto/ArenaRuntime.h"
+
+#include <cstdint>
+
+#include "kyoto/ModuleCompiler.h"
+#include "kyoto/RuntimeSupport.h"
+#include "llvm/IR/Attributes.h"
+#include "llvm/IR/BasicBlock.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Module.h"
+
+namespace {
+
+constexpr uint64_t chunk_size = 64 * 1024;
+// Chunks start with a pointer to the previous chunk, padded so that the first object is 16-byte aligned like malloc's.
+constexpr uint64_t chunk_header_size = 16;
+
+// { next free byte, end of the current chunk, most recent chunk }
+llvm::StructType* get_arena_type(llvm::LLVMContext& context)
+{
+    constexpr auto* type_name = "kyoto.arena";
+    if (auto* existing = llvm::StructType::getTypeByName(context, type_name)) return existing;
+
+    auto* ptr_type = llvm::PointerType::get(context, 0);
+    return llvm::StructType::create(context, { ptr_type, ptr_type, ptr_type }, type_name);
+}
+
+llvm::Function* get_arena_alloc_fn(ModuleCompiler& compiler);
+
+// Chains a fresh chunk large enough for the request, then retries the allocation.
+llvm::Function* get_arena_grow_fn(ModuleCompiler& compiler)
+{
+    constexpr auto* name = "__kyoto_arena_grow";
+    auto* module = compiler.get_module();
+    if (auto* existing = module->getFunction(name)) return existing;
+
+    auto& context = compiler.get_context();
+    auto* ptr_type = llvm::PointerType::get(context, 0);
+    auto* i64_type = llvm::Type::getInt64Ty(context);
+    auto* type = llvm::FunctionType::get(ptr_type, { ptr_type, i64_type, i64_type }, false);
+    auto* function = declare_runtime_function(compiler, name, type);
+    function->addFnAttr(llvm::Attribute::NoInline);
+    function->addFnAttr(llvm::Attribute::Cold);
+
+    auto* arena = function->getArg(0);
+    auto* size = function->getArg(1);
+    auto* align = function->getArg(2);
+
+    auto* entry = llvm::BasicBlock::Create(context, "entry", function);
+    auto* out_of_memory = llvm::BasicBlock::Create(context, "out_of_memory", function);
+    auto* link = llvm::BasicBlock::Create(context, "link", function);
+
+    llvm::IRBuilder<> builder(entry);
+    auto* arena_type = get_arena_type(context);
+    auto* needed = builder.CreateAdd(builder.CreateAdd(size, align), builder.getInt64(chunk_header_size));
+    auto* default_size = builder.getInt64(chunk_size);
+    auto* bytes = builder.CreateSelect(builder.CreateICmpUGT(needed, default_size), needed, default_size);
+    auto* chunk = builder.CreateCall(module->getFunction("malloc"), { bytes }, "chunk");
+    builder.CreateCondBr(builder.CreateIsNull(chunk), out_of_memory, link);
+
+    builder.SetInsertPoint(out_of_memory);
+    gen_runtime_error(compiler, builder, "__kyoto_arena_out_of_memory", "runtime error: out of memory in arena");
+
+    builder.SetInsertPoint(link);
+    auto* chunks_ptr = builder.CreateStructGEP(arena_type, arena, 2);
+    builder.CreateStore(builder.CreateLoad(ptr_type, chunks_ptr), chunk);
+    builder.CreateStore(chunk, chunks_ptr);
+    builder.CreateStore(builder.CreateGEP(builder.getInt8Ty(), chunk, builder.getInt64(chunk_header_size)),
+                        builder.CreateStructGEP(arena_type, arena, 0));
+    builder.CreateStore(builder.CreateGEP(builder.getInt8Ty(), chunk, bytes),
+                        builder.CreateStructGEP(arena_type, arena, 1));
+
+    builder.CreateRet(builder.CreateCall(get_arena_alloc_fn(compiler), { arena, size, align }));
+    return function;
+}
+
+// Rounds the next free byte up to `align` and bumps it past the object, falling back to a new chunk when the current
+// one (if any) is exhausted.
+llvm::Function* get_arena_alloc_fn(ModuleCompiler& compiler)
+{
+    constexpr auto* name = "__kyoto_arena_alloc";
+    auto* module = compiler.get_module();
+    if (auto* existing = module->getFunction(name)) return existing;
+
+    auto& context = compiler.get_context();
+    auto* ptr_type = llvm::PointerType::get(context, 0);
+    auto* i64_type = llvm::Type::getInt64Ty(context);
+    auto* type = llvm::FunctionType::get(ptr_type, { ptr_type, i64_type, i64_type }, false);
+    auto* function = declare_runtime_function(compiler, name, type);
+
+    auto* arena = function->getArg(0);
+    auto* size = function->getArg(1);
+    auto* align = function->getArg(2);
+
+    auto* entry = llvm::BasicBlock::Create(context, "entry", function);
+    auto* bump = llvm::BasicBlock::Create(context, "bump", function);
+    auto* grow = llvm::BasicBlock::Create(context, "grow", function);
+
+    llvm::IRBuilder<> builder(entry);
+    auto* arena_type = get_arena_type(context);
+    auto* next_ptr = builder.CreateStructGEP(arena_type, arena, 0);
+    auto* next = builder.CreateLoad(ptr_type, next_ptr, "next");
+    auto* end = builder.CreateLoad(ptr_type, builder.CreateStructGEP(arena_type, arena, 1), "end");
+
+    auto* address = builder.CreatePtrToInt(next, i64_type);
+    auto* mask = builder.CreateSub(align, builder.getInt64(1));
+    auto* padding = builder.CreateAnd(builder.CreateNeg(address), mask, "padding");
+    auto* available = builder.CreateSub(builder.CreatePtrToInt(end, i64_type), address);
+    // Computed without forming the bumped address so that it cannot wrap.
+    auto* fits = builder.CreateAnd(builder.CreateIsNotNull(next),
+                                   builder.CreateICmpULE(size, builder.CreateSub(available, padding)));
+    auto* has_padding_room = builder.CreateICmpULE(padding, available);
+    builder.CreateCondBr(builder.CreateAnd(has_padding_room, fits), bump, grow);
+
+    builder.SetInsertPoint(bump);
+    auto* object = builder.CreateGEP(builder.getInt8Ty(), next, padding, "object");
+    builder.CreateStore(builder.CreateGEP(builder.getInt8Ty(), object, size), next_ptr);
+    builder.CreateRet(object);
+
+    builder.SetInsertPoint(grow);
+    builder.CreateRet(builder.CreateCall(get_arena_grow_fn(compiler), { arena, size, align }));
+    return function;
+}
+
+// Frees every chunk of the arena, newest first.
+llvm::Function* get_arena_release_fn(ModuleCompiler& compiler)
+{
+    constexpr auto* name = "__kyoto_arena_release";
+    auto* module = compiler.get_module();
+    if (auto* existing = module->getFunction(name)) return existing;
+
+    auto& context = compiler.get_context();
+    auto* ptr_type = llvm::PointerType::get(context, 0);
+    auto* type = llvm::FunctionType::get(llvm::Type::getVoidTy(context), { ptr_type }, false);
+    auto* function = declare_runtime_function(compiler, name, type);
+    auto* arena = function->getArg(0);
+
+    auto* entry = llvm::BasicBlock::Create(context, "entry", function);
+    auto* loop = llvm::BasicBlock::Create(context, "loop", function);
+    auto* body = llvm::BasicBlock::Create(context, "body", function);
+    auto* done = llvm::BasicBlock::Create(context, "done", function);
+
+    llvm::IRBuilder<> builder(entry);
+    auto* head = builder.CreateLoad(ptr_type, builder.CreateStructGEP(get_arena_type(context), arena, 2), "head");
+    builder.CreateBr(loop);
+
+    builder.SetInsertPoint(loop);
+    auto* chunk = builder.CreatePHI(ptr_type, 2, "chunk");
+    chunk->addIncoming(head, entry);
+    builder.CreateCondBr(builder.CreateIsNull(chunk), done, body);
+
+    builder.SetInsertPoint(body);
+    auto* previous = builder.CreateLoad(ptr_type, chunk, "previous");
+    builder.CreateCall(module->getFunction("free"), { chunk });
+    chunk->addIncoming(previous, body);
+    builder.CreateBr(loop);
+
+    builder.SetInsertPoint(done);
+    builder.CreateRetVoid();
+    return function;
+}
+
+}
+
+llvm::AllocaInst* create_arena(ModuleCompiler& compiler)
+{
+    auto* arena_type = get_arena_type(compiler.get_context());
+    auto* arena = compiler.create_entry_block_alloca(arena_type, "arena");
+    compiler.get_builder().CreateStore(llvm::ConstantAggregateZero::get(arena_type), arena);
+    return arena;
+}
+
+llvm::Value* gen_arena_alloc(ModuleCompiler& compiler, llvm::Value* arena, llvm::Value* size, uint64_t align)
+{
+    auto& builder = compiler.get_builder();
+    return builder.CreateCall(get_arena_alloc_fn(compiler), { arena, size, builder.getInt64(align) });
+}
+
+void gen_arena_release(ModuleCompiler& compiler, llvm::Value* arena)
+{
+    compiler.get_builder().CreateCall(get_arena_release_fn(compiler), { arena });
+}
@@ -1,9 +1,28 @@
 #include "kyoto/KType.h"
 
+#include <assert.h>
 #include <format>
+#include <new>
 #include <utility>
 
+#include "kyoto/TypeContext.h"
 #include "llvm/IR/Type.h"
+#include "llvm/Support/Casting.h"
+
+void KType::operator delete(KType* type, std::destroying_delete_t)
+{
+    if (type->interned || type->arena_allocated) return;
+    type->~KType();
+    ::operator delete(type);
+}
+
+bool KType::operator==(const KType& other) const
+{
+    if (this == &other) return true;
+    // Interned types are unique per structure, so two distinct ones never compare equal.
+    if (interned && other.interned) return false;
+    return equals(other);
+}
 
 KType* KType::get_void()
 {
@@ -12,7 +31,8 @@ KType* KType::get_void()
 }
 
 PrimitiveType::PrimitiveType(Kind kind)
-    : kind(kind)
+    : KType(TypeKind::Primitive)
+    , kind(kind)
 {
 }
 
@@ -42,14 +62,9 @@ std::string PrimitiveType::to_string() const
     }
 }
 
-bool PrimitiveType::is_primitive() const
+bool PrimitiveType::equals(const KType& other) const
 {
-    return true;
-}
-
-bool PrimitiveType::operator==(const KType& other) const
-{
-    auto* other_primitive = dynamic_cast<const PrimitiveType*>(&other);
+    auto* other_primitive = llvm::dyn_cast<PrimitiveType>(&other);
     if (!other_primitive) return false;
 
     return kind == other_primitive->kind;
@@ -113,6 +128,7 @@ size_t PrimitiveType::width() const
 
 KType* PrimitiveType::copy() const
 {
+    if (is_interned()) return const_cast<PrimitiveType*>(this);
     return new PrimitiveType(kind);
 }
 
@@ -121,29 +137,30 @@ PrimitiveType::Kind PrimitiveType::get_kind() const
     return kind;
 }
 
-KType* KType::from_llvm_type(const llvm::Type* type)
+KType* KType::from_llvm_type(const llvm::Type* type, TypeContext& types)
 {
     using Kind = PrimitiveType::Kind;
-    if (type->isIntegerTy(1)) return new PrimitiveType(Kind::Boolean);
-    if (type->isIntegerTy(8)) return new PrimitiveType(Kind::I8);
-    if (type->isIntegerTy(16)) return new PrimitiveType(Kind::I16);
-    if (type->isIntegerTy(32)) return new PrimitiveType(Kind::I32);
-    if (type->isIntegerTy(64)) return new PrimitiveType(Kind::I64);
+    if (type->isIntegerTy(1)) return types.primitive(Kind::Boolean);
+    if (type->isIntegerTy(8)) return types.primitive(Kind::I8);
+    if (type->isIntegerTy(16)) return types.primitive(Kind::I16);
+    if (type->isIntegerTy(32)) return types.primitive(Kind::I32);
+    if (type->isIntegerTy(64)) return types.primitive(Kind::I64);
 
-    if (type->isFloatTy()) return new PrimitiveType(Kind::F32);
-    if (type->isDoubleTy()) return new PrimitiveType(Kind::F64);
+    if (type->isFloatTy()) return types.primitive(Kind::F32);
+    if (type->isDoubleTy()) return types.primitive(Kind::F64);
 
     // The only "pointer" type we support for now is string, so we can safely
     // return it here.
-    if (type->isPointerTy()) return new PointerType(new PrimitiveType(Kind::Char));
+    if (type->isPointerTy()) return types.pointer(types.primitive(Kind::Char));
 
-    if (type->isVoidTy()) return new PrimitiveType(Kind::Void);
+    if (type->isVoidTy()) return types.primitive(Kind::Void);
 
-    return new PrimitiveType(Kind::Unknown);
+    return types.primitive(Kind::Unknown);
 }
 
 PointerType::PointerType(KType* pointee)
-    : pointee(pointee)
+    : KType(TypeKind::Pointer)
+    , pointee(pointee)
 {
 }
 
@@ -157,11 +174,6 @@ std::string PointerType::to_string() const
     return pointee->to_string() + "*";
 }
 
-bool PointerType::is_pointer() const
-{
-    return true;
-}
-
 KType* PointerType::get_pointee() const
 {
     return pointee;
@@ -180,13 +192,13 @@ std::string PointerType::get_class_name() const
 
 bool PointerType::is_string() const
 {
-    const auto* pt = dynamic_cast<PrimitiveType*>(pointee);
+    const auto* pt = llvm::dyn_cast<PrimitiveType>(pointee);
     return pt && pt->get_kind() == PrimitiveType::Kind::Char;
 }
 
-bool PointerType::operator==(const KType& other) const
+bool PointerType::equals(const KType& other) const
 {
-    auto* other_pointer = dynamic_cast<const PointerType*>(&other);
+    auto* other_pointer = llvm::dyn_cast<PointerType>(&other);
     if (!other_pointer) return false;
 
     return *pointee == *other_pointer->pointee;
@@ -194,11 +206,13 @@ bool PointerType::operator==(const KType& other) const
 
 KType* PointerType::copy() const
 {
+    if (is_interned()) return const_cast<PointerType*>(this);
     return new PointerType(pointee->copy());
 }
 
 ClassType::ClassType(std::string name)
-    : name(std::move(name))
+    : KType(TypeKind::Class)
+    , name(std::move(name))
 {
 }
 
@@ -209,14 +223,9 @@ std::string ClassType::to_string() const
     return "Class " + name;
 }
 
-bool ClassType::is_class() const
-{
-    return true;
-}
-
-bool ClassType::operator==(const KType& other) const
+bool ClassType::equals(const KType& other) const
 {
-    auto* other_class = dynamic_cast<const ClassType*>(&other);
+    auto* other_class = llvm::dyn_cast<ClassType>(&other);
     if (!other_class) return false;
 
     return name == other_class->name;
@@ -224,6 +233,7 @@ bool ClassType::operator==(const KType& other) const
 
 KType* ClassType::copy() const
 {
+    if (is_interned()) return const_cast<ClassType*>(this);
     return new ClassType(name);
 }
 
@@ -233,7 +243,8 @@ std::string ClassType::get_class_name() const
 }
 
 ArrayType::ArrayType(KType* element_type, size_t n)
-    : element_type(element_type)
+    : KType(TypeKind::Array)
+    , element_type(element_type)
     , size(n)
 {
 }
@@ -248,9 +259,9 @@ std::string ArrayType::to_string() const
     return std::format("{}[{}]", element_type->to_string(), size);
 }
 
-bool ArrayType::operator==(const KType& other) const
+bool ArrayType::equals(const KType& other) const
 {
-    auto* other_array = dynamic_cast<const ArrayType*>(&other);
+    auto* other_array = llvm::dyn_cast<ArrayType>(&other);
     if (!other_array) return false;
 
     return *element_type == *other_array->element_type && size == other_array->size;
@@ -258,11 +269,13 @@ bool ArrayType::operator==(const KType& other) const
 
 KType* ArrayType::copy() const
 {
+    if (is_interned()) return const_cast<ArrayType*>(this);
     return new ArrayType(element_type->copy());
 }
 
 FunctionType::FunctionType(std::vector<KType*> param_types, KType* return_type)
-    : param_types(std::move(param_types))
+    : KType(TypeKind::Function)
+    , param_types(std::move(param_types))
     , return_type(return_type)
 {
 }
@@ -286,9 +299,9 @@ std::string FunctionType::to_string() const
     return result;
 }
 
-bool FunctionType::operator==(const KType& other) const
+bool FunctionType::equals(const KType& other) const
 {
-    const auto* other_function = dynamic_cast<const FunctionType*>(&other);
+    const auto* other_function = llvm::dyn_cast<FunctionType>(&other);
     if (!other_function) return false;
     if (*return_type != *other_function->return_type) return false;
     if (param_types.size() != other_function->param_types.size()) return false;
@@ -302,6 +315,7 @@ bool FunctionType::operator==(const KType& other) const
 
 KType* FunctionType::copy() const
 {
+    if (is_interned()) return const_cast<FunctionType*>(this);
     std::vector<KType*> copied_param_types;
     copied_param_types.reserve(param_types.size());
     for (auto* param_type : param_types)
@@ -309,11 +323,6 @@ KType* FunctionType::copy() const
     return new FunctionType(std::move(copied_param_types), return_type->copy());
 }
 
-bool FunctionType::is_function() const
-{
-    return true;
-}
-
 const std::vector<KType*>& FunctionType::get_param_types() const
 {
     return param_types;
@@ -329,11 +338,6 @@ KType* ArrayType::get_element_type() const
     return element_type;
 }
 
-bool ArrayType::is_array() const
-{
-    return true;
-}
-
 size_t ArrayType::get_size() const
 {
     return size;
@@ -341,11 +345,13 @@ size_t ArrayType::get_size() const
 
 void ArrayType::set_size(size_t n)
 {
+    assert(!is_interned() && "interned types are immutable");
     size = n;
 }
 
 SliceType::SliceType(KType* element_type)
-    : element_type(element_type)
+    : KType(TypeKind::Slice)
+    , element_type(element_type)
 {
 }
 
@@ -359,9 +365,9 @@ std::string SliceType::to_string() const
     return std::format("[{}]", element_type->to_string());
 }
 
-bool SliceType::operator==(const KType& other) const
+bool SliceType::equals(const KType& other) const
 {
-    auto* other_slice = dynamic_cast<const SliceType*>(&other);
+    auto* other_slice = llvm::dyn_cast<SliceType>(&other);
     if (!other_slice) return false;
 
     return *element_type == *other_slice->element_type;
@@ -369,15 +375,52 @@ bool SliceType::operator==(const KType& other) const
 
 KType* SliceType::copy() const
 {
+    if (is_interned()) return const_cast<SliceType*>(this);
     return new SliceType(element_type->copy());
 }
 
-bool SliceType::is_slice() const
+KType* SliceType::get_element_type() const
 {
-    return true;
+    return element_type;
 }
 
-KType* SliceType::get_element_type() const
+VectorType::VectorType(KType* element_type, size_t lanes)
+    : KType(TypeKind::Vector)
+    , element_type(element_type)
+    , lanes(lanes)
+{
+}
+
+VectorType::~VectorType()
+{
+    delete element_type;
+}
+
+std::string VectorType::to_string() const
+{
+    return std::format("{}x{}", element_type->to_string(), lanes);
+}
+
+bool VectorType::equals(const KType& other) const
+{
+    auto* other_vector = llvm::dyn_cast<VectorType>(&other);
+    if (!other_vector) return false;
+
+    return *element_type == *other_vector->element_type && lanes == other_vector->lanes;
+}
+
+KType* VectorType::copy() const
+{
+    if (is_interned()) return const_cast<VectorType*>(this);
+    return new VectorType(element_type->copy(), lanes);
+}
+
+KType* VectorType::get_element_type() const
 {
     return element_type;
 }
+
+size_t VectorType::get_lanes() const
+{
+    return lanes;
+}
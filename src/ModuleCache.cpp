@@ -0,0 +1,103 @@
+#include "kyoto/ModuleCache.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
+
+ModuleCache::ModuleCache(std::filesystem::path directory)
+    : directory(std::move(directory))
+{
+}
+
+std::filesystem::path ModuleCache::default_directory()
+{
+    if (const auto* xdg_cache = std::getenv("XDG_CACHE_HOME"); xdg_cache && *xdg_cache) {
+        return std::filesystem::path(xdg_cache) / "cyoto";
+    }
+    if (const auto* home = std::getenv("HOME"); home && *home) {
+        return std::filesystem::path(home) / ".cache" / "cyoto";
+    }
+    return std::filesystem::temp_directory_path() / "cyoto";
+}
+
+std::string ModuleCache::compiler_version()
+{
+    // The compiler is identified by a hash of its own binary, so that any rebuild, even one that only recompiled some
+    // other source file, never reuses older entries. A binary that cannot be read gets a key of its own per run.
+    static const auto version = [] {
+        const auto executable = llvm::sys::fs::getMainExecutable(nullptr, nullptr);
+        auto binary = llvm::MemoryBuffer::getFile(executable, false, false);
+        const auto build = binary ? llvm::xxh3_64bits(llvm::arrayRefFromStringRef((*binary)->getBuffer()))
+                                  : static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count());
+        return std::format("cyoto {:016x}{} llvm {}", build, binary ? "" : " unidentified", LLVM_VERSION_STRING);
+    }();
+    return version;
+}
+
+std::unique_ptr<llvm::Module> ModuleCache::load(uint64_t key, llvm::LLVMContext& context) const
+{
+    auto buffer = llvm::MemoryBuffer::getFile(entry_path(key).string());
+    if (!buffer) return nullptr;
+
+    auto module = llvm::parseBitcodeFile((*buffer)->getMemBufferRef(), context);
+    if (!module) {
+        // A truncated or foreign entry is treated as a miss and overwritten by the next store.
+        llvm::consumeError(module.takeError());
+        return nullptr;
+    }
+    return std::move(*module);
+}
+
+bool ModuleCache::store(uint64_t key, const llvm::Module& module) const
+{
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    if (ec) return false;
+
+    // Write under a process-unique name and rename into place so concurrent builds never observe a partial entry.
+    const auto final_path = entry_path(key);
+    auto temp_path = final_path;
+    temp_path += std::format(".tmp{}", llvm::sys::Process::getProcessId());
+
+    {
+        llvm::raw_fd_ostream out(temp_path.string(), ec, llvm::sys::fs::OF_None);
+        if (ec) return false;
+        llvm::WriteBitcodeToFile(module, out);
+        out.close();
+        if (out.has_error()) {
+            out.clear_error();
+            std::filesystem::remove(temp_path, ec);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temp_path, final_path, ec);
+    if (ec) {
+        std::filesystem::remove(temp_path, ec);
+        return false;
+    }
+    return true;
+}
+
+std::filesystem::path ModuleCache::entry_path(uint64_t key) const
+{
+    return directory / std::format("{:016x}.bc", key);
+}
@@ -1,16 +1,12 @@
 #include "kyoto/ModuleCompiler.h"
 
-#include <BailErrorStrategy.h>
-#include <BaseErrorListener.h>
 #include <Exceptions.h>
 #include <Parser.h>
-#include <RecognitionException.h>
-#include <Token.h>
-#include <Vocabulary.h>
 #include <algorithm>
 #include <any>
 #include <assert.h>
 #include <cctype>
+#include <cstdio>
 #include <cstdlib>
 #include <exception>
 #include <filesystem>
@@ -19,120 +15,185 @@
 #include <iostream>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/Support/TypeSize.h>
-#include <misc/IntervalSet.h>
-#include <regex>
+#include <memory>
 #include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
-#include "ANTLRInputStream.h"
-#include "CommonTokenStream.h"
-#include "KyotoLexer.h"
 #include "KyotoParser.h"
 #include "kyoto/AST/ASTNode.h"
 #include "kyoto/AST/ClassDefinitionNode.h"
 #include "kyoto/Analysis/FunctionTermination.h"
+#include "kyoto/Analysis/HeapToStack.h"
 #include "kyoto/KType.h"
+#include "kyoto/ParsedModule.h"
 #include "kyoto/Resolution/ClassIdentifierVisitor.h"
 #include "kyoto/Resolution/ConstructorIdentifierVisitor.h"
 #include "kyoto/Resolution/FunctionIdentifierVisitor.h"
 #include "kyoto/Visitor.h"
 #include "kyoto/utils/File.h"
 #include "llvm/ADT/APInt.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/Analysis/CGSCCPassManager.h"
 #include "llvm/Analysis/LoopAnalysisManager.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
 #include "llvm/IR/Argument.h"
 #include "llvm/IR/BasicBlock.h"
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/DerivedTypes.h"
 #include "llvm/IR/Function.h"
+#include "llvm/IR/GlobalVariable.h"
 #include "llvm/IR/Instructions.h"
+#include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/PassManager.h"
 #include "llvm/IR/Type.h"
 #include "llvm/IR/Value.h"
 #include "llvm/IR/Verifier.h"
+#include "llvm/Linker/Linker.h"
+#include "llvm/MC/TargetRegistry.h"
+#include "llvm/Passes/OptimizationLevel.h"
 #include "llvm/Passes/PassBuilder.h"
+#include "llvm/Support/CodeGen.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
+#include "llvm/Target/TargetOptions.h"
 #include "llvm/TargetParser/Host.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+#include "llvm/Transforms/Utils/ValueMapper.h"
 
-class LexerErrorListener : public antlr4::BaseErrorListener {
-public:
-    void syntaxError(antlr4::Recognizer* recognizer, antlr4::Token* offendingSymbol, size_t line,
-                     size_t charPositionInLine, const std::string& msg, std::exception_ptr e) override
-    {
-        throw std::runtime_error(std::format("Lexer error at line {}, char {}: {}", line, charPositionInLine, msg));
-    }
-};
+namespace {
 
-class ParserErrorListener : public antlr4::BaseErrorListener {
-public:
-    void syntaxError(antlr4::Recognizer* recognizer, antlr4::Token* offendingSymbol, size_t line,
-                     size_t charPositionInLine, const std::string& msg, std::exception_ptr e) override
-    {
-        throw std::runtime_error(std::format("Parser error at line {}, char {}: {}", line, charPositionInLine, msg));
-    }
-};
+void report_error(const std::string& msg)
+{
+    constexpr auto* RED = "\033[0;31m";
+    constexpr auto* NC = "\033[0m";
+    std::cerr << RED << "Error: " << NC << msg << std::endl;
+}
 
-class CustomBailErrorStrategy : public antlr4::BailErrorStrategy {
-public:
-    void recover(antlr4::Parser* recognizer, std::exception_ptr e) override
-    {
-        try {
-            std::rethrow_exception(e);
-        } catch (const antlr4::RecognitionException& ex) {
-            std::string msg = std::format("Parse error at line {}, char {}: {}", ex.getOffendingToken()->getLine(),
-                                          ex.getOffendingToken()->getCharPositionInLine(), ex.what());
-            throw antlr4::ParseCancellationException(msg);
-        } catch (...) {
-            antlr4::BailErrorStrategy::recover(recognizer, e);
-        }
-    }
+void report_remark(const std::string& msg)
+{
+    constexpr auto* CYAN = "\033[0;36m";
+    constexpr auto* NC = "\033[0m";
+    std::cerr << CYAN << "Remark: " << NC << msg << std::endl;
+}
 
-    antlr4::Token* recoverInline(antlr4::Parser* recognizer) override
-    {
-        auto* currentToken = recognizer->getCurrentToken();
-        auto expectedTokens = recognizer->getExpectedTokens();
+llvm::OptimizationLevel to_llvm_opt_level(OptLevel level)
+{
+    switch (level) {
+    case OptLevel::O0:
+        return llvm::OptimizationLevel::O0;
+    case OptLevel::O1:
+        return llvm::OptimizationLevel::O1;
+    case OptLevel::O2:
+        return llvm::OptimizationLevel::O2;
+    case OptLevel::O3:
+        return llvm::OptimizationLevel::O3;
+    case OptLevel::Os:
+        return llvm::OptimizationLevel::Os;
+    }
+    return llvm::OptimizationLevel::O0;
+}
 
-        std::string expectedStr = "one of: ";
-        auto& vocab = recognizer->getVocabulary();
-        bool first = true;
+llvm::CodeGenOptLevel to_codegen_opt_level(OptLevel level)
+{
+    switch (level) {
+    case OptLevel::O0:
+        return llvm::CodeGenOptLevel::None;
+    case OptLevel::O1:
+        return llvm::CodeGenOptLevel::Less;
+    case OptLevel::O2:
+    case OptLevel::Os:
+        return llvm::CodeGenOptLevel::Default;
+    case OptLevel::O3:
+        return llvm::CodeGenOptLevel::Aggressive;
+    }
+    return llvm::CodeGenOptLevel::None;
+}
 
-        for (size_t token : expectedTokens.toList()) {
-            if (!first) expectedStr += ", ";
-            first = false;
+std::unordered_set<const llvm::Function*> collect_defined_functions(const llvm::Module& module)
+{
+    std::unordered_set<const llvm::Function*> defined;
+    for (const auto& fn : module) {
+        if (!fn.isDeclaration()) defined.insert(&fn);
+    }
+    return defined;
+}
 
-            std::string tokenName = std::string(vocab.getSymbolicName(token));
-            if (tokenName.empty()) {
-                tokenName = std::string(vocab.getLiteralName(token));
-                if (tokenName.empty()) {
-                    tokenName = std::to_string(token);
-                } else if (tokenName.size() >= 2 && tokenName[0] == '\'' && tokenName.back() == '\'') {
-                    tokenName = tokenName.substr(1, tokenName.size() - 2);
-                }
-            }
-            expectedStr += tokenName;
+std::vector<std::string> collect_imports(ParsedModule& parsed)
+{
+    std::vector<std::string> imports;
+    for (auto* top_level : parsed.tree->topLevel()) {
+        if (!top_level->importStatement()) continue;
+
+        std::string module_name;
+        auto* module_path = top_level->importStatement()->modulePath();
+        for (auto* identifier : module_path->IDENTIFIER()) {
+            if (!module_name.empty()) module_name += ".";
+            module_name += identifier->getText();
         }
+        imports.push_back(module_name);
+    }
+    return imports;
+}
 
-        std::string foundToken = currentToken->getText();
-        std::string msg
-            = std::format("Parse error at line {}, char {}: expected {}, but found '{}'", currentToken->getLine(),
-                          currentToken->getCharPositionInLine(), expectedStr, foundToken);
-
-        throw antlr4::ParseCancellationException(msg);
+// Removes private functions and globals that nothing refers to anymore, repeating until no more become dead.
+void drop_unused_local_values(llvm::Module& module)
+{
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto& value : llvm::make_early_inc_range(module.global_values())) {
+            if (!value.hasLocalLinkage() || !value.use_empty()) continue;
+            value.eraseFromParent();
+            changed = true;
+        }
     }
-};
+}
+
+}
 
 ModuleCompiler::ModuleCompiler(const std::string& code, const std::string& name,
-                               std::optional<std::filesystem::path> entry_path)
+                               std::optional<std::filesystem::path> entry_path, CompilerOptions options)
     : code(code)
     , name(name)
     , entry_path(std::move(entry_path))
+    , options(options)
+    , ts_context(std::make_unique<llvm::LLVMContext>())
+    , context(*ts_context.getContext())
     , builder(context)
     , module(std::make_unique<llvm::Module>(name, context))
     , data_layout(module->getDataLayout())
 {
-    module->setTargetTriple(llvm::sys::getDefaultTargetTriple());
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+    llvm::InitializeNativeTargetAsmParser();
+
+    const auto triple = llvm::sys::getDefaultTargetTriple();
+    module->setTargetTriple(triple);
+
+    std::string target_error;
+    if (const auto* target = llvm::TargetRegistry::lookupTarget(triple, target_error)) {
+        target_machine.reset(target->createTargetMachine(triple, "generic", "", llvm::TargetOptions {},
+                                                         llvm::Reloc::PIC_, std::nullopt,
+                                                         to_codegen_opt_level(options.opt_level)));
+        module->setDataLayout(target_machine->createDataLayout());
+        data_layout = module->getDataLayout();
+    }
+
+    if (options.cache_dir) module_cache.emplace(*options.cache_dir);
+
     type_alias_scopes.emplace_back();
     current_module_name = "__main__";
     register_visitors();
@@ -140,24 +201,10 @@ ModuleCompiler::ModuleCompiler(const std::string& code, const std::string& name,
     register_free();
 }
 
-ASTNode* ModuleCompiler::parse_program(const std::string& source)
+ASTNode* ModuleCompiler::build_program_ast(ParsedModule& parsed)
 {
-    antlr4::ANTLRInputStream input(source);
-    kyoto::KyotoLexer lexer(&input);
-    lexer.removeErrorListeners();
-    lexer.addErrorListener(new LexerErrorListener());
-    antlr4::CommonTokenStream tokens(&lexer);
-    tokens.fill();
-
-    kyoto::KyotoParser parser(&tokens);
-    parser.removeErrorListeners();
-    parser.addErrorListener(new ParserErrorListener());
-    parser.setBuildParseTree(true);
-    parser.setErrorHandler(std::make_unique<CustomBailErrorStrategy>());
-    auto* tree = parser.program();
-
     ASTBuilderVisitor visitor(*this);
-    return std::any_cast<ASTNode*>(visitor.visit(tree));
+    return std::any_cast<ASTNode*>(visitor.visit(parsed.tree));
 }
 
 void ModuleCompiler::enter_module_context(const std::string& module_name)
@@ -172,6 +219,13 @@ void ModuleCompiler::enter_module_context(const std::string& module_name)
     }
 }
 
+ASTArena& ModuleCompiler::get_ast_arena()
+{
+    auto& arena = ast_arenas[current_module_name];
+    if (!arena) arena = std::make_unique<ASTArena>();
+    return *arena;
+}
+
 std::string ModuleCompiler::mangle_module_name(const std::string& module_name) const
 {
     std::string mangled = module_name;
@@ -223,6 +277,24 @@ std::vector<std::string> ModuleCompiler::resolve_function_lookup_names(const std
     return result;
 }
 
+uint32_t ModuleCompiler::intern_function_name(const std::string& name) const
+{
+    const auto [it, inserted] = function_name_ids.try_emplace(name, static_cast<uint32_t>(overloads_by_name.size()));
+    if (inserted) overloads_by_name.emplace_back();
+    return it->second;
+}
+
+const std::vector<uint32_t>& ModuleCompiler::lookup_function_name_ids(const std::string& name) const
+{
+    auto& ids = lookup_name_ids[current_module_name][name];
+    if (ids.empty()) {
+        for (const auto& lookup_name : resolve_function_lookup_names(name)) {
+            ids.push_back(intern_function_name(lookup_name));
+        }
+    }
+    return ids;
+}
+
 std::string ModuleCompiler::qualify_local_name(const std::string& entity_name) const
 {
     return make_qualified_name(current_module_name, entity_name);
@@ -249,100 +321,52 @@ bool ModuleCompiler::is_imported_module_visible(const std::string& module_name)
     return it->second.contains(module_name);
 }
 
-std::vector<std::string> ModuleCompiler::parse_imports(const std::string& source,
-                                                       const std::filesystem::path& path) const
+void ModuleCompiler::parse_loaded_modules(std::vector<LoadedModule>& modules) const
 {
-    try {
-        antlr4::ANTLRInputStream input(source);
-        kyoto::KyotoLexer lexer(&input);
-        lexer.removeErrorListeners();
-        lexer.addErrorListener(new LexerErrorListener());
-        antlr4::CommonTokenStream tokens(&lexer);
-        tokens.fill();
-
-        kyoto::KyotoParser parser(&tokens);
-        parser.removeErrorListeners();
-        parser.addErrorListener(new ParserErrorListener());
-        parser.setBuildParseTree(true);
-        parser.setErrorHandler(std::make_unique<CustomBailErrorStrategy>());
-        auto* tree = parser.program();
-
-        std::vector<std::string> imports;
-        for (auto* rawTopLevel : tree->topLevel()) {
-            auto* topLevel = const_cast<kyoto::KyotoParser::TopLevelContext*>(rawTopLevel);
-            if (!topLevel->importStatement()) continue;
-
-            std::string module_name;
-            auto* modulePath
-                = const_cast<kyoto::KyotoParser::ModulePathContext*>(topLevel->importStatement()->modulePath());
-            for (size_t i = 0; i < modulePath->IDENTIFIER().size(); ++i) {
-                if (!module_name.empty()) module_name += ".";
-                module_name += modulePath->IDENTIFIER(i)->getText();
-            }
-            imports.push_back(module_name);
-        }
-        return imports;
-    } catch (const std::exception& e) {
-        throw std::runtime_error(std::format("{}: {}", path.string(), e.what()));
-    }
-}
-
-void ModuleCompiler::load_module_recursive(const std::string& module_name, const std::filesystem::path& path,
-                                           const std::string* source, std::vector<std::string>& stack)
-{
-    const auto normalized_path = std::filesystem::weakly_canonical(path);
-
-    if (std::find(stack.begin(), stack.end(), module_name) != stack.end()) {
-        std::string cycle;
-        for (const auto& item : stack) {
-            if (!cycle.empty()) cycle += " -> ";
-            cycle += item;
+    auto parse = [](LoadedModule& loaded) {
+        try {
+            loaded.parsed = ParsedModule::parse(loaded.code);
+            loaded.imports = collect_imports(*loaded.parsed);
+        } catch (const std::exception& e) {
+            throw std::runtime_error(std::format("{}: {}", loaded.path.string(), e.what()));
         }
-        cycle += " -> " + module_name;
-        throw std::runtime_error(std::format("Import cycle detected: {}", cycle));
-    }
+    };
 
-    const auto existing = loaded_modules.find(module_name);
-    if (existing != loaded_modules.end()) {
-        if (existing->second.path != normalized_path) {
-            throw std::runtime_error(std::format("Module `{}` resolves to multiple files: `{}` and `{}`", module_name,
-                                                 existing->second.path.string(), normalized_path.string()));
+    if (options.jobs == 1 || modules.size() < 2) {
+        for (auto& loaded : modules) {
+            parse(loaded);
         }
         return;
     }
 
-    std::string module_source = source ? *source : utils::File::get_source(normalized_path.string());
-    stack.push_back(module_name);
-
-    auto imports = parse_imports(module_source, normalized_path);
-    loaded_modules.emplace(module_name,
-                           LoadedModule { module_name, normalized_path, std::move(module_source), std::move(imports) });
-    module_imports[module_name] = {};
-
-    const auto base_dir = normalized_path.parent_path();
-    const auto imported_names = loaded_modules.at(module_name).imports;
-    for (const auto& imported_module : imported_names) {
-        module_imports[module_name].insert(imported_module);
-
-        std::filesystem::path imported_path = base_dir;
-        std::string relative = imported_module;
-        std::replace(relative.begin(), relative.end(), '.', std::filesystem::path::preferred_separator);
-        imported_path /= relative + ".kyo";
-        if (!std::filesystem::exists(imported_path)) {
-            throw std::runtime_error(std::format("{}: imported module `{}` not found at `{}`", normalized_path.string(),
-                                                 imported_module, imported_path.string()));
-        }
-
-        load_module_recursive(imported_module, imported_path, nullptr, stack);
+    // Parsing only reads the module's own source, so it is the one frontend stage that can run concurrently. Building
+    // the AST registers classes, templates and aliases in the compiler and stays serial in dependency order.
+    // Fill the shared DFA cache first so the workers do not all contend on it while predicting the same rules.
+    ParsedModule::warm_up();
+    std::vector<std::exception_ptr> errors(modules.size());
+    llvm::DefaultThreadPool pool(llvm::hardware_concurrency(options.jobs));
+    for (size_t i = 0; i < modules.size(); ++i) {
+        pool.async([&, i] {
+            try {
+                parse(modules[i]);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        });
     }
+    pool.wait();
 
-    stack.pop_back();
+    for (const auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
 }
 
 void ModuleCompiler::load_modules()
 {
     loaded_modules.clear();
     module_imports.clear();
+    lookup_name_ids.clear();
+    current_module_name = "__main__";
 
     if (!entry_path.has_value()) {
         const auto inline_path = std::filesystem::path("<memory>");
@@ -352,18 +376,68 @@ void ModuleCompiler::load_modules()
                                    inline_path,
                                    code,
                                    {},
+                                   ParsedModule::parse(code),
                                });
         module_imports["__main__"] = {};
         current_source_path = inline_path;
-        current_module_name = "__main__";
         return;
     }
 
     auto root_path = std::filesystem::weakly_canonical(*entry_path);
-    std::vector<std::string> stack;
-    load_module_recursive("__main__", root_path, &code, stack);
+    std::unordered_map<std::string, std::filesystem::path> discovered { { "__main__", root_path } };
+    std::vector<LoadedModule> pending;
+    pending.push_back(LoadedModule { "__main__", root_path, code, {}, nullptr });
+
+    // The import graph is walked one level at a time so that all files of a level are parsed concurrently. The parse
+    // trees are kept for AST building, so every file is parsed exactly once.
+    while (!pending.empty()) {
+        parse_loaded_modules(pending);
+
+        std::vector<LoadedModule> next;
+        for (auto& loaded : pending) {
+            auto& imports = module_imports[loaded.name];
+            const auto base_dir = loaded.path.parent_path();
+
+            for (const auto& imported_module : loaded.imports) {
+                imports.insert(imported_module);
+
+                std::filesystem::path imported_path = base_dir;
+                std::string relative = imported_module;
+                std::replace(relative.begin(), relative.end(), '.', std::filesystem::path::preferred_separator);
+                imported_path /= relative + ".kyo";
+                if (!std::filesystem::exists(imported_path)) {
+                    throw std::runtime_error(std::format("{}: imported module `{}` not found at `{}`",
+                                                         loaded.path.string(), imported_module,
+                                                         imported_path.string()));
+                }
+                imported_path = std::filesystem::weakly_canonical(imported_path);
+
+                if (const auto existing = discovered.find(imported_module); existing != discovered.end()) {
+                    if (existing->second != imported_path) {
+                        throw std::runtime_error(std::format("Module `{}` resolves to multiple files: `{}` and `{}`",
+                                                             imported_module, existing->second.string(),
+                                                             imported_path.string()));
+                    }
+                    continue;
+                }
+
+                discovered.emplace(imported_module, imported_path);
+                next.push_back(LoadedModule {
+                    imported_module,
+                    imported_path,
+                    utils::File::get_source(imported_path.string()),
+                    {},
+                    nullptr,
+                });
+            }
+
+            auto module_name = loaded.name;
+            loaded_modules.emplace(std::move(module_name), std::move(loaded));
+        }
+        pending = std::move(next);
+    }
+
     current_source_path = root_path;
-    current_module_name = "__main__";
 }
 
 std::vector<std::string> ModuleCompiler::topo_sort_modules() const
@@ -374,19 +448,27 @@ std::vector<std::string> ModuleCompiler::topo_sort_modules() const
     std::vector<std::string> ordered;
     ordered.reserve(loaded_modules.size());
 
+    std::vector<std::string> stack;
     std::function<void(const std::string&)> dfs = [&](const std::string& module_name) {
         auto state = states[module_name];
         if (state == VisitState::Done) return;
         if (state == VisitState::Visiting) {
-            throw std::runtime_error(std::format("Import cycle detected at `{}`", module_name));
+            std::string cycle;
+            for (auto it = std::find(stack.begin(), stack.end(), module_name); it != stack.end(); ++it) {
+                cycle += *it + " -> ";
+            }
+            cycle += module_name;
+            throw std::runtime_error(std::format("Import cycle detected: {}", cycle));
         }
 
         states[module_name] = VisitState::Visiting;
+        stack.push_back(module_name);
         if (const auto imports_it = module_imports.find(module_name); imports_it != module_imports.end()) {
             for (const auto& dependency : imports_it->second) {
                 dfs(dependency);
             }
         }
+        stack.pop_back();
 
         states[module_name] = VisitState::Done;
         ordered.push_back(module_name);
@@ -400,16 +482,21 @@ std::unique_ptr<ASTNode> ModuleCompiler::build_module_ast(const std::string& mod
 {
     enter_module_context(module_name);
     instantiated_nodes.clear();
-    return std::unique_ptr<ASTNode>(parse_program(code));
+    return std::unique_ptr<ASTNode>(build_program_ast(*loaded_modules.at(module_name).parsed));
 }
 
-void ModuleCompiler::llvm_pass()
+void ModuleCompiler::run_module_pipeline(
+    llvm::Module& target, const std::function<llvm::ModulePassManager(llvm::PassBuilder&)>& build_pipeline)
 {
     llvm::LoopAnalysisManager LAM;
     llvm::FunctionAnalysisManager FAM;
     llvm::CGSCCAnalysisManager CGAM;
     llvm::ModuleAnalysisManager MAM;
-    llvm::PassBuilder PB;
+    llvm::PassBuilder PB(target_machine.get());
+
+    for (auto& callback : pass_callbacks) {
+        callback(PB);
+    }
 
     PB.registerModuleAnalyses(MAM);
     PB.registerCGSCCAnalyses(CGAM);
@@ -417,13 +504,103 @@ void ModuleCompiler::llvm_pass()
     PB.registerLoopAnalyses(LAM);
     PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
 
-    llvm::FunctionPassManager FPM;
-    FPM.addPass(FunctionTerminationPass(*this));
+    build_pipeline(PB).run(target, MAM);
+}
+
+void ModuleCompiler::llvm_pass()
+{
+    run_module_pipeline(*module, [this](llvm::PassBuilder&) {
+        llvm::FunctionPassManager FPM;
+        FPM.addPass(FunctionTerminationPass(*this));
+
+        llvm::ModulePassManager MPM;
+        MPM.addPass(llvm::createModuleToFunctionPassAdaptor(std::move(FPM)));
+        MPM.addPass(HeapToStackPass(*this));
+        return MPM;
+    });
+
+    // The Kyoto passes complete the IR, so the module is only valid (and safe to optimize) after they ran.
+    std::string llvm_err;
+    llvm::raw_string_ostream err(llvm_err);
+    if (!verify_module(err)) {
+        throw std::runtime_error(err.str());
+    }
+}
+
+void ModuleCompiler::optimize_module(llvm::Module& target)
+{
+    const auto level = to_llvm_opt_level(options.opt_level);
+    run_module_pipeline(target, [level](llvm::PassBuilder& PB) {
+        return level == llvm::OptimizationLevel::O0 ? PB.buildO0DefaultPipeline(level)
+                                                    : PB.buildPerModuleDefaultPipeline(level);
+    });
+}
 
-    llvm::ModulePassManager MPM;
-    MPM.addPass(llvm::createModuleToFunctionPassAdaptor(std::move(FPM)));
+uint64_t ModuleCompiler::compute_cache_key(const std::string& module_name,
+                                           const std::unordered_map<std::string, uint64_t>& import_keys) const
+{
+    const auto& loaded = loaded_modules.at(module_name);
+    auto material = std::format("{}\n{}\n{}\n{}\n{}\n{}\n", ModuleCache::compiler_version(),
+                                module->getTargetTriple(), static_cast<int>(options.opt_level),
+                                static_cast<int>(options.bounds_checks), static_cast<int>(options.alloc), module_name);
+
+    // Imported keys already cover their own imports, so this folds in the whole transitive closure.
+    if (const auto imports = module_imports.find(module_name); imports != module_imports.end()) {
+        for (const auto& imported_module : imports->second) {
+            material += std::format("{}={:016x}\n", imported_module, import_keys.at(imported_module));
+        }
+    }
+
+    material += loaded.code;
+    return llvm::xxh3_64bits(llvm::arrayRefFromStringRef(material));
+}
 
-    MPM.run(*module, MAM);
+std::unique_ptr<llvm::Module> ModuleCompiler::extract_module_unit(const std::string& module_name,
+                                                                  const std::vector<llvm::Function*>& functions) const
+{
+    const std::unordered_set<const llvm::GlobalValue*> owned(functions.begin(), functions.end());
+
+    // Everything the module defines, plus the private helpers, string constants and template instance methods its
+    // bodies may refer to.
+    llvm::ValueToValueMapTy value_map;
+    auto unit = llvm::CloneModule(*module, value_map, [&](const llvm::GlobalValue* value) {
+        return owned.contains(value) || value->hasLocalLinkage() || value->hasLinkOnceLinkage();
+    });
+    unit->setModuleIdentifier(mangle_module_name(module_name));
+    drop_unused_local_values(*unit);
+    return unit;
+}
+
+std::vector<std::unique_ptr<llvm::Module>>
+ModuleCompiler::split_cached_modules(const std::vector<std::string>& module_order,
+                                     const std::vector<std::vector<llvm::Function*>>& owned_functions)
+{
+    std::vector<std::unique_ptr<llvm::Module>> units;
+    std::unordered_map<std::string, uint64_t> keys;
+
+    for (size_t i = 0; i < module_order.size(); ++i) {
+        const auto& module_name = module_order[i];
+        const auto key = compute_cache_key(module_name, keys);
+        keys[module_name] = key;
+
+        // The entry module is what is being edited, so it is always optimized from scratch.
+        if (module_name == "__main__" || owned_functions[i].empty()) continue;
+
+        auto unit = module_cache->load(key, context);
+        if (!unit) {
+            unit = extract_module_unit(module_name, owned_functions[i]);
+            optimize_module(*unit);
+            module_cache->store(key, *unit);
+        }
+
+        for (auto* fn : owned_functions[i]) {
+            fn->deleteBody();
+        }
+        units.push_back(std::move(unit));
+    }
+
+    drop_unused_local_values(*module);
+    return units;
 }
 
 void ModuleCompiler::ensure_main_fn() const
@@ -462,14 +639,73 @@ llvm::BasicBlock* ModuleCompiler::create_basic_block(const std::string& name)
     return llvm::BasicBlock::Create(context, name, builder.GetInsertBlock()->getParent());
 }
 
-std::optional<std::string> ModuleCompiler::gen_ir()
+void ModuleCompiler::remark(const std::string& msg) const
 {
-    auto report_error = [](const std::string& msg) {
-        constexpr auto* RED = "\033[0;31m";
-        constexpr auto* NC = "\033[0m";
-        std::cerr << RED << "Error: " << NC << msg << std::endl;
-    };
+    if (options.opt_remarks) report_remark(msg);
+}
 
+llvm::GlobalVariable* ModuleCompiler::get_constant_global(llvm::Constant* value, const std::string& name)
+{
+    auto& global = constant_pool[value];
+    if (!global) {
+        global = new llvm::GlobalVariable(*module, value->getType(), true, llvm::GlobalValue::PrivateLinkage, value,
+                                          name);
+        global->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
+    }
+    return global;
+}
+
+llvm::GlobalVariable* ModuleCompiler::get_string_constant(const std::string& value)
+{
+    auto* global = get_constant_global(llvm::ConstantDataArray::getString(context, value), ".str");
+    if (!global->getAlign()) global->setAlignment(llvm::Align(1));
+    return global;
+}
+
+llvm::AllocaInst* ModuleCompiler::create_entry_block_alloca(llvm::Type* type, const std::string& name)
+{
+    auto* insert_block = builder.GetInsertBlock();
+    if (!insert_block || !insert_block->getParent()) {
+        throw std::runtime_error(std::format("Cannot allocate local `{}` outside of a function", name));
+    }
+
+    // Keeping every local in the entry block bounds the frame size and lets mem2reg/SROA promote them.
+    auto& entry = insert_block->getParent()->getEntryBlock();
+    llvm::IRBuilder<> entry_builder(&entry, entry.getFirstInsertionPt());
+    return entry_builder.CreateAlloca(type, nullptr, name);
+}
+
+const SliceIndexFact* ModuleCompiler::find_slice_index_fact(const llvm::AllocaInst* index,
+                                                            const llvm::AllocaInst* slice) const
+{
+    for (auto it = slice_index_facts.rbegin(); it != slice_index_facts.rend(); ++it) {
+        if (it->index == index && it->slice == slice) return &*it;
+    }
+    return nullptr;
+}
+
+llvm::AllocaInst* ModuleCompiler::get_current_arena() const
+{
+    const auto* function = builder.GetInsertBlock()->getParent();
+    for (auto it = arenas.rbegin(); it != arenas.rend(); ++it) {
+        if ((*it)->getFunction() == function) return *it;
+    }
+    return nullptr;
+}
+
+// Innermost first, which is the order they are released in.
+std::vector<llvm::AllocaInst*> ModuleCompiler::get_function_arenas() const
+{
+    std::vector<llvm::AllocaInst*> result;
+    const auto* function = builder.GetInsertBlock()->getParent();
+    for (auto it = arenas.rbegin(); it != arenas.rend(); ++it) {
+        if ((*it)->getFunction() == function) result.push_back(*it);
+    }
+    return result;
+}
+
+bool ModuleCompiler::gen_module()
+{
     try {
         load_modules();
 
@@ -489,30 +725,49 @@ std::optional<std::string> ModuleCompiler::gen_ir()
             }
         }
 
+        std::vector<std::vector<llvm::Function*>> owned_functions(module_order.size());
         for (size_t i = 0; i < module_order.size(); ++i) {
             enter_module_context(module_order[i]);
+            std::unordered_set<const llvm::Function*> defined_before;
+            if (module_cache) defined_before = collect_defined_functions(*module);
             module_asts[i]->gen();
+            if (!module_cache) continue;
+
+            for (auto& fn : *module) {
+                if (fn.isDeclaration() || fn.hasLocalLinkage() || fn.hasLinkOnceLinkage()) continue;
+                if (!defined_before.contains(&fn)) owned_functions[i].push_back(&fn);
+            }
         }
 
-        llvm_pass();
         ensure_main_fn();
+        llvm_pass();
+
+        auto cached_units = module_cache ? split_cached_modules(module_order, owned_functions)
+                                         : std::vector<std::unique_ptr<llvm::Module>> {};
+        optimize_module(*module);
+        for (auto& unit : cached_units) {
+            const auto unit_name = unit->getModuleIdentifier();
+            if (llvm::Linker::linkModules(*module, std::move(unit))) {
+                throw std::runtime_error(std::format("Failed to link cached module `{}`", unit_name));
+            }
+        }
     } catch (const antlr4::ParseCancellationException& e) {
         report_error(e.what());
-        return std::nullopt;
+        return false;
     } catch (const std::exception& e) {
         report_error(e.what());
-        return std::nullopt;
+        return false;
     } catch (...) {
         report_error("Unknown exception");
-        return std::nullopt;
+        return false;
     }
 
-    std::string llvm_err;
-    llvm::raw_string_ostream err(llvm_err);
-    if (!verify_module(err)) {
-        std::cerr << "Error: " << err.str() << std::endl;
-        return std::nullopt;
-    }
+    return true;
+}
+
+std::optional<std::string> ModuleCompiler::gen_ir()
+{
+    if (!gen_module()) return std::nullopt;
 
     std::string llvm_ir;
     llvm::raw_string_ostream os(llvm_ir);
@@ -520,16 +775,135 @@ std::optional<std::string> ModuleCompiler::gen_ir()
     return os.str();
 }
 
+std::optional<int32_t> ModuleCompiler::run_jit()
+{
+    if (!module) {
+        report_error("No module to run, it has already been handed to the JIT");
+        return std::nullopt;
+    }
+
+    auto jit_target = llvm::orc::JITTargetMachineBuilder::detectHost();
+    if (!jit_target) {
+        report_error(llvm::toString(jit_target.takeError()));
+        return std::nullopt;
+    }
+    jit_target->setCodeGenOptLevel(to_codegen_opt_level(options.opt_level));
+
+    auto jit = llvm::orc::LLJITBuilder().setJITTargetMachineBuilder(std::move(*jit_target)).create();
+    if (!jit) {
+        report_error(llvm::toString(jit.takeError()));
+        return std::nullopt;
+    }
+
+    // `cdecl` functions, `malloc` and `free` are resolved against the symbols of the host process.
+    auto& main_jd = (*jit)->getMainJITDylib();
+    auto host_symbols
+        = llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess((*jit)->getDataLayout().getGlobalPrefix());
+    if (!host_symbols) {
+        report_error(llvm::toString(host_symbols.takeError()));
+        return std::nullopt;
+    }
+    main_jd.addGenerator(std::move(*host_symbols));
+
+    if (auto err = (*jit)->addIRModule(llvm::orc::ThreadSafeModule(std::move(module), ts_context))) {
+        report_error(llvm::toString(std::move(err)));
+        return std::nullopt;
+    }
+
+    if (auto err = (*jit)->initialize(main_jd)) {
+        report_error(llvm::toString(std::move(err)));
+        return std::nullopt;
+    }
+
+    auto main_addr = (*jit)->lookup("main");
+    if (!main_addr) {
+        report_error(llvm::toString(main_addr.takeError()));
+        return std::nullopt;
+    }
+
+    auto* main_fn = main_addr->toPtr<int32_t (*)()>();
+    int32_t ret = main_fn();
+    std::fflush(nullptr);
+
+    if (auto err = (*jit)->deinitialize(main_jd)) {
+        report_error(llvm::toString(std::move(err)));
+        return std::nullopt;
+    }
+
+    return ret;
+}
+
+bool ModuleCompiler::emit(EmitKind kind, const std::filesystem::path& output_path)
+{
+    if (!module) {
+        report_error("No module to emit, it has already been handed to the JIT");
+        return false;
+    }
+
+    const bool binary = kind == EmitKind::Bitcode || kind == EmitKind::Object;
+    std::error_code ec;
+    llvm::raw_fd_ostream out(output_path.string(), ec, binary ? llvm::sys::fs::OF_None : llvm::sys::fs::OF_Text);
+    if (ec) {
+        report_error(std::format("Failed to open `{}`: {}", output_path.string(), ec.message()));
+        return false;
+    }
+
+    switch (kind) {
+    case EmitKind::IR:
+        module->print(out, nullptr);
+        return true;
+    case EmitKind::Bitcode:
+        llvm::WriteBitcodeToFile(*module, out);
+        return true;
+    case EmitKind::Assembly:
+    case EmitKind::Object:
+        break;
+    }
+
+    if (!target_machine) {
+        report_error(std::format("No code generator available for target `{}`", module->getTargetTriple()));
+        return false;
+    }
+
+    // The codegen pipeline lowers the IR in place, so IR and bitcode should be emitted before objects.
+    llvm::legacy::PassManager codegen;
+    const auto file_type
+        = kind == EmitKind::Object ? llvm::CodeGenFileType::ObjectFile : llvm::CodeGenFileType::AssemblyFile;
+    if (target_machine->addPassesToEmitFile(codegen, out, nullptr, file_type)) {
+        report_error(std::format("Target `{}` cannot emit this file type", module->getTargetTriple()));
+        return false;
+    }
+
+    codegen.run(*module);
+    out.flush();
+    return true;
+}
+
+SymbolTable::SymbolId ModuleCompiler::intern_symbol(const std::string& name)
+{
+    return symbol_table.intern(name);
+}
+
 std::optional<Symbol> ModuleCompiler::get_symbol(const std::string& name)
 {
     return symbol_table.get_symbol(name);
 }
 
+std::optional<Symbol> ModuleCompiler::get_symbol(SymbolTable::SymbolId id)
+{
+    return symbol_table.get_symbol(id);
+}
+
 void ModuleCompiler::add_symbol(const std::string& name, Symbol symbol)
 {
     symbol_table.add_symbol(name, symbol);
 }
 
+void ModuleCompiler::add_symbol(SymbolTable::SymbolId id, Symbol symbol)
+{
+    symbol_table.add_symbol(id, symbol);
+}
+
 void ModuleCompiler::add_function(FunctionNode* node)
 {
     std::string key = make_function_key(node);
@@ -538,16 +912,21 @@ void ModuleCompiler::add_function(FunctionNode* node)
                                              node->get_name(), make_function_signature_suffix(node)));
     }
     functions[key] = node;
+
+    const auto id = intern_function_name(node->get_name());
+    overloads_by_name[id].push_back(node);
+    overloads_by_arity[{ id, node->get_params().size() }].push_back(node);
+    resolved_calls.clear();
 }
 
 std::optional<FunctionNode*> ModuleCompiler::get_function(const std::string& name)
 {
     FunctionNode* result = nullptr;
-    const auto lookup_names = resolve_function_lookup_names(name);
-    for (const auto& [_, func] : functions) {
-        if (std::find(lookup_names.begin(), lookup_names.end(), func->get_name()) == lookup_names.end()) continue;
-        if (result) return std::nullopt;
-        result = func;
+    for (const auto id : lookup_function_name_ids(name)) {
+        for (auto* func : overloads_by_name[id]) {
+            if (result) return std::nullopt;
+            result = func;
+        }
     }
     if (!result) return std::nullopt;
     return result;
@@ -563,10 +942,9 @@ std::optional<FunctionNode*> ModuleCompiler::get_function(const std::string& nam
 std::vector<FunctionNode*> ModuleCompiler::get_functions(const std::string& name, size_t arity) const
 {
     std::vector<FunctionNode*> result;
-    const auto lookup_names = resolve_function_lookup_names(name);
-    for (const auto& [_, func] : functions) {
-        if (std::find(lookup_names.begin(), lookup_names.end(), func->get_name()) == lookup_names.end()) continue;
-        if (func->get_params().size() == arity) result.push_back(func);
+    for (const auto id : lookup_function_name_ids(name)) {
+        const auto it = overloads_by_arity.find({ id, arity });
+        if (it != overloads_by_arity.end()) result.insert(result.end(), it->second.begin(), it->second.end());
     }
     return result;
 }
@@ -574,20 +952,37 @@ std::vector<FunctionNode*> ModuleCompiler::get_functions(const std::string& name
 std::optional<FunctionNode*> ModuleCompiler::get_external_varargs_function(const std::string& name, size_t arity) const
 {
     FunctionNode* result = nullptr;
-    const auto lookup_names = resolve_function_lookup_names(name);
-    for (const auto& [_, func] : functions) {
-        if (std::find(lookup_names.begin(), lookup_names.end(), func->get_name()) == lookup_names.end()) continue;
-        if (!func->is_external() || !func->is_varargs()) continue;
-        if (func->get_params().size() > arity) continue;
-        if (result) {
-            throw std::runtime_error(std::format("Multiple cdecl varargs declarations match function `{}`", name));
+    for (const auto id : lookup_function_name_ids(name)) {
+        for (auto* func : overloads_by_name[id]) {
+            if (!func->is_external() || !func->is_varargs()) continue;
+            if (func->get_params().size() > arity) continue;
+            if (result) {
+                throw std::runtime_error(std::format("Multiple cdecl varargs declarations match function `{}`", name));
+            }
+            result = func;
         }
-        result = func;
     }
     if (!result) return std::nullopt;
     return result;
 }
 
+std::optional<FunctionNode*> ModuleCompiler::get_resolved_call(const std::string& name, size_t param_offset,
+                                                               const CallSignature& signature) const
+{
+    const auto module_it = resolved_calls.find(current_module_name);
+    if (module_it == resolved_calls.end()) return std::nullopt;
+
+    const auto it = module_it->second.find({ intern_function_name(name), param_offset, signature });
+    if (it == module_it->second.end()) return std::nullopt;
+    return it->second;
+}
+
+void ModuleCompiler::cache_resolved_call(const std::string& name, size_t param_offset, CallSignature signature,
+                                         FunctionNode* fn)
+{
+    resolved_calls[current_module_name][{ intern_function_name(name), param_offset, std::move(signature) }] = fn;
+}
+
 std::string ModuleCompiler::get_function_llvm_name(const FunctionNode* node) const
 {
     if (node->get_linkage_name() == "main" && !node->is_external()) return "main";
@@ -597,10 +992,10 @@ std::string ModuleCompiler::get_function_llvm_name(const FunctionNode* node) con
 
 void ModuleCompiler::register_malloc()
 {
-    auto* ret_type = new PointerType(new PrimitiveType(PrimitiveType::Kind::I8));
+    auto* ret_type = type_context.pointer(type_context.primitive(PrimitiveType::Kind::I8));
     FunctionNode::Parameter param;
     param.name = "size";
-    param.type = new PrimitiveType(PrimitiveType::Kind::I64);
+    param.type = type_context.primitive(PrimitiveType::Kind::I64);
     std::vector<FunctionNode::Parameter> args = { param };
     auto* malloc = new FunctionNode("malloc", args, false, ret_type, nullptr, *this, true, "malloc");
     add_function(malloc);
@@ -612,7 +1007,7 @@ void ModuleCompiler::register_free()
     auto* ret_type = KType::get_void();
     FunctionNode::Parameter param;
     param.name = "ptr";
-    param.type = new PointerType(new PrimitiveType(PrimitiveType::Kind::I8));
+    param.type = type_context.pointer(type_context.primitive(PrimitiveType::Kind::I8));
     std::vector<FunctionNode::Parameter> args = { param };
     auto* free = new FunctionNode("free", args, false, ret_type, nullptr, *this, true, "free");
     add_function(free);
@@ -621,9 +1016,10 @@ void ModuleCompiler::register_free()
 
 void ModuleCompiler::register_visitors()
 {
-    analysis_visitors.push_back(std::make_unique<ConstructorIdentifierVisitor>(*this));
-    analysis_visitors.push_back(std::make_unique<ClassIdentifierVisitor>(*this));
-    analysis_visitors.push_back(std::make_unique<FunctionIdentifierVisitor>(*this));
+    using DeclarationVisitor
+        = FusedAnalysisVisitor<ConstructorIdentifierVisitor, ClassIdentifierVisitor, FunctionIdentifierVisitor>;
+    analysis_visitors.push_back(std::make_unique<DeclarationVisitor>(
+        ConstructorIdentifierVisitor(*this), ClassIdentifierVisitor(*this), FunctionIdentifierVisitor(*this)));
 }
 
 void ModuleCompiler::push_scope()
@@ -640,7 +1036,7 @@ void ModuleCompiler::push_scope()
             llvm::Value* arg = &*iter;
             auto arg_name = current_fn_node->get_params()[i++].name;
             auto* arg_type = arg->getType();
-            auto* arg_alloc = builder.CreateAlloca(arg_type, nullptr, arg_name);
+            auto* arg_alloc = create_entry_block_alloca(arg_type, arg_name);
             builder.CreateStore(arg, arg_alloc);
             symbol_table.add_symbol(arg_name, Symbol { arg_alloc, current_fn_node->get_params()[i - 1].type->copy() });
         }
@@ -812,6 +1208,11 @@ std::string ModuleCompiler::mangle_type_name(const KType* type) const
 
     if (type->is_slice()) return "S_" + mangle_type_name(type->as<SliceType>()->get_element_type());
 
+    if (type->is_vector()) {
+        const auto* vector_type = type->as<VectorType>();
+        return "V" + std::to_string(vector_type->get_lanes()) + "_" + mangle_type_name(vector_type->get_element_type());
+    }
+
     if (type->is_class()) return "C" + sanitize_mangled_component(type->get_class_name());
 
     if (type->is_function()) {
@@ -913,37 +1314,26 @@ void ModuleCompiler::pop_type_alias_scope()
     if (!type_alias_scopes.empty()) type_alias_scopes.pop_back();
 }
 
+void ModuleCompiler::register_template(const std::string& name, const std::string& param,
+                                       kyoto::KyotoParser::ClassDefinitionContext* definition)
+{
+    std::shared_ptr<ParsedModule> source;
+    if (const auto it = loaded_modules.find(current_module_name); it != loaded_modules.end()) {
+        source = it->second.parsed;
+    }
+    template_registry[name] = { param, definition, std::move(source) };
+}
+
 void ModuleCompiler::instantiate_template(const std::string& name, const std::string& mangled_name,
-                                          const std::string& type_str)
+                                          const KType* argument)
 {
     if (classes.contains(mangled_name)) return;
-    if (std::find_if(instantiated_nodes.begin(), instantiated_nodes.end(),
-                     [&](ASTNode* n) {
-                         auto* cdn = dynamic_cast<ClassDefinitionNode*>(n);
-                         return cdn && cdn->get_name() == mangled_name;
-                     })
-        != instantiated_nodes.end()) {
-        return;
-    }
 
-    if (!template_registry.contains(name)) throw std::runtime_error("Template " + name + " not found");
+    const auto tmpl = template_registry.find(name);
+    if (tmpl == template_registry.end()) throw std::runtime_error("Template " + name + " not found");
 
     classes.insert(mangled_name);
 
-    auto& tmpl = template_registry[name];
-    std::string text = tmpl.raw_text;
-    std::string source_template_name = name;
-    if (const auto pos = source_template_name.rfind("__"); pos != std::string::npos) {
-        source_template_name = source_template_name.substr(pos + 2);
-    }
-
-    std::regex reg("\\b" + tmpl.param + "\\b");
-
-    std::string class_decl = "class\\s+" + source_template_name + "\\s*<\\s*" + tmpl.param + "\\s*>";
-    std::regex class_reg(class_decl);
-    std::string new_text = std::regex_replace(text, class_reg, "class " + mangled_name);
-    new_text = std::regex_replace(new_text, reg, type_str);
-
     const auto previous_module_name = current_module_name;
     const auto previous_source_path = current_source_path;
     const auto previous_code = code;
@@ -953,15 +1343,12 @@ void ModuleCompiler::instantiate_template(const std::string& name, const std::st
         enter_module_context(owner_module);
     }
 
-    antlr4::ANTLRInputStream input(new_text);
-    kyoto::KyotoLexer lexer(&input);
-    antlr4::CommonTokenStream tokens(&lexer);
-    kyoto::KyotoParser parser(&tokens);
-    parser.removeErrorListeners();
-    auto tree = parser.classDefinition();
-
-    ASTBuilderVisitor visitor(*this);
-    auto node = std::any_cast<ASTNode*>(visitor.visitClassDefinition(tree));
+    const TemplateInstance instance { mangled_name, tmpl->second.param, argument };
+    ASTBuilderVisitor visitor(*this, &instance);
+    auto node = std::any_cast<ASTNode*>(visitor.visitClassDefinition(tmpl->second.definition));
+    for (auto* component : node->as<ClassDefinitionNode>()->get_components()) {
+        if (auto* method = component->as<FunctionNode>()) method->mark_template_instance();
+    }
 
     current_module_name = previous_module_name;
     current_source_path = previous_source_path;
@@ -0,0 +1,226 @@
+#include "kyoto/ParsedModule.h"
+
+#include <BailErrorStrategy.h>
+#include <BaseErrorListener.h>
+#include <Exceptions.h>
+#include <Parser.h>
+#include <RecognitionException.h>
+#include <Token.h>
+#include <Vocabulary.h>
+#include <atn/ParserATNSimulator.h>
+#include <atn/PredictionMode.h>
+#include <exception>
+#include <format>
+#include <memory>
+#include <misc/IntervalSet.h>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+class LexerErrorListener : public antlr4::BaseErrorListener {
+public:
+    void syntaxError(antlr4::Recognizer* recognizer, antlr4::Token* offendingSymbol, size_t line,
+                     size_t charPositionInLine, const std::string& msg, std::exception_ptr e) override
+    {
+        throw std::runtime_error(std::format("Lexer error at line {}, char {}: {}", line, charPositionInLine, msg));
+    }
+};
+
+class ParserErrorListener : public antlr4::BaseErrorListener {
+public:
+    void syntaxError(antlr4::Recognizer* recognizer, antlr4::Token* offendingSymbol, size_t line,
+                     size_t charPositionInLine, const std::string& msg, std::exception_ptr e) override
+    {
+        throw std::runtime_error(std::format("Parser error at line {}, char {}: {}", line, charPositionInLine, msg));
+    }
+};
+
+namespace {
+
+// Vector type names such as `i32x4` are keywords, which the generic messages do not make obvious.
+void reject_vector_type_as_name(antlr4::Token* token)
+{
+    if (token->getType() != kyoto::KyotoLexer::VECTOR_TYPE) return;
+    throw antlr4::ParseCancellationException(
+        std::format("Parse error at line {}, char {}: `{}` is a vector type and cannot be used as a name",
+                    token->getLine(), token->getCharPositionInLine(), token->getText()));
+}
+
+}
+
+class CustomBailErrorStrategy : public antlr4::BailErrorStrategy {
+public:
+    void recover(antlr4::Parser* recognizer, std::exception_ptr e) override
+    {
+        try {
+            std::rethrow_exception(e);
+        } catch (const antlr4::RecognitionException& ex) {
+            reject_vector_type_as_name(ex.getOffendingToken());
+            std::string msg = std::format("Parse error at line {}, char {}: {}", ex.getOffendingToken()->getLine(),
+                                          ex.getOffendingToken()->getCharPositionInLine(), ex.what());
+            throw antlr4::ParseCancellationException(msg);
+        } catch (...) {
+            antlr4::BailErrorStrategy::recover(recognizer, e);
+        }
+    }
+
+    antlr4::Token* recoverInline(antlr4::Parser* recognizer) override
+    {
+        auto* currentToken = recognizer->getCurrentToken();
+        auto expectedTokens = recognizer->getExpectedTokens();
+        if (expectedTokens.contains(kyoto::KyotoLexer::IDENTIFIER)) reject_vector_type_as_name(currentToken);
+
+        std::string expectedStr = "one of: ";
+        auto& vocab = recognizer->getVocabulary();
+        bool first = true;
+
+        for (size_t token : expectedTokens.toList()) {
+            if (!first) expectedStr += ", ";
+            first = false;
+
+            std::string tokenName = std::string(vocab.getSymbolicName(token));
+            if (tokenName.empty()) {
+                tokenName = std::string(vocab.getLiteralName(token));
+                if (tokenName.empty()) {
+                    tokenName = std::to_string(token);
+                } else if (tokenName.size() >= 2 && tokenName[0] == '\'' && tokenName.back() == '\'') {
+                    tokenName = tokenName.substr(1, tokenName.size() - 2);
+                }
+            }
+            expectedStr += tokenName;
+        }
+
+        std::string foundToken = currentToken->getText();
+        std::string msg
+            = std::format("Parse error at line {}, char {}: expected {}, but found '{}'", currentToken->getLine(),
+                          currentToken->getCharPositionInLine(), expectedStr, foundToken);
+
+        throw antlr4::ParseCancellationException(msg);
+    }
+};
+
+namespace {
+
+// Syntactically touches every top-level, statement, expression and type rule. It only has to parse, not type-check.
+constexpr auto* WARM_UP_SOURCE = R"(
+import warm.up;
+cdecl fn printf(fmt: str, ...) i32;
+typealias i64 word;
+var global: i32 = 1;
+
+class Box<T> : Base {
+    var value: T;
+    var next: Box<T>*;
+
+    constructor(value: T) {
+        this.value = value;
+    }
+
+    fn get() T {
+        return this.value;
+    }
+}
+
+fn sample(a: i32, b: [i32], f: fn(i32, bool) i32, p: warm.up::Node<char>**, c: char[]) f64 {
+    var x: i64 = (i64)a * 2 + 3 - 4 / 5 % 6;
+    var y = x;
+    var w: word;
+    var arr: i32[] = i32{1, 2, 3};
+    var s: [i32] = [&arr[0], 3];
+    var q: Box<i32>* = new Box<i32>(1);
+    var r: i8* = new i8[10];
+    var v: i32x4 = (i32x4)a;
+    var mask: boolx4 = v < (i32x4)2;
+    if (x < 1 && y >= 2 || !(x == y)) {
+        ++x;
+    } else if (x != y && x <= y) {
+        --x;
+    } else {
+        x = -x + +y;
+    }
+    for (var i: i64 = 0; i < s.size; ++i) {
+        y = y + s[i];
+    }
+    for (;;) {
+        x = x - 1;
+    }
+    while (x > 0) {
+        x = x - 1;
+    }
+    var m = match a {
+        1 => 2,
+        default => 3,
+    };
+    var g = fn(v: i32) i32 {
+        return v;
+    };
+    var z: i32 = q.get() + q.value + (g)(1) + warm.up::call(1, 'c', "s") + sizeof(i32) + sizeof(x) + *r;
+    var t: bool = true || false;
+    v[0] = v.sum();
+    with arena {
+        var aligned: i8* = new align(64) zeroed i8[64];
+    }
+    free q;
+    {
+        return 1.5;
+    }
+}
+)";
+
+void configure_stage(kyoto::KyotoParser& parser, antlr4::atn::PredictionMode mode)
+{
+    parser.getInterpreter<antlr4::atn::ParserATNSimulator>()->setPredictionMode(mode);
+}
+
+}
+
+std::unique_ptr<ParsedModule> ParsedModule::parse(const std::string& source, Prediction prediction)
+{
+    auto parsed = std::make_unique<ParsedModule>();
+    parsed->lexer_errors = std::make_unique<LexerErrorListener>();
+    parsed->parser_errors = std::make_unique<ParserErrorListener>();
+
+    parsed->input = std::make_unique<antlr4::ANTLRInputStream>(source);
+    parsed->lexer = std::make_unique<kyoto::KyotoLexer>(parsed->input.get());
+    parsed->lexer->removeErrorListeners();
+    parsed->lexer->addErrorListener(parsed->lexer_errors.get());
+    parsed->tokens = std::make_unique<antlr4::CommonTokenStream>(parsed->lexer.get());
+    parsed->tokens->fill();
+
+    parsed->parser = std::make_unique<kyoto::KyotoParser>(parsed->tokens.get());
+    parsed->parser->setBuildParseTree(true);
+    parsed->parser->removeErrorListeners();
+
+    if (prediction == Prediction::TwoStage) {
+        // SLL ignores the full parser context during prediction, which makes it much cheaper on the large expression
+        // rule. It accepts every valid program except a few pathological ones, and bails out on anything it cannot
+        // decide, so a failure here only means the input needs the full LL stage (or has a real syntax error).
+        configure_stage(*parsed->parser, antlr4::atn::PredictionMode::SLL);
+        parsed->parser->setErrorHandler(std::make_unique<antlr4::BailErrorStrategy>());
+        try {
+            parsed->tree = parsed->parser->program();
+            return parsed;
+        } catch (const antlr4::ParseCancellationException&) {
+            parsed->parser->reset();
+        }
+    }
+
+    configure_stage(*parsed->parser, antlr4::atn::PredictionMode::LL);
+    parsed->parser->addErrorListener(parsed->parser_errors.get());
+    parsed->parser->setErrorHandler(std::make_unique<CustomBailErrorStrategy>());
+    parsed->tree = parsed->parser->program();
+    return parsed;
+}
+
+void ParsedModule::warm_up()
+{
+    static std::once_flag warmed_up;
+    std::call_once(warmed_up, [] {
+        kyoto::KyotoParser::initialize();
+        try {
+            (void)parse(WARM_UP_SOURCE);
+        } catch (const std::exception&) {
+            // Warming up is best effort; whatever was predicted before the error is already cached.
+        }
+    });
+}
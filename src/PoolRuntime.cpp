@@ -0,0 +1,174 @@
+#include "kyoto/PoolRuntime.h"
+
+#include <cstdint>
+
+#include "kyoto/ModuleCompiler.h"
+#include "kyoto/RuntimeSupport.h"
+#include "llvm/IR/Attributes.h"
+#include "llvm/IR/BasicBlock.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Module.h"
+
+namespace {
+
+constexpr uint64_t size_class_granularity = 16;
+constexpr uint64_t size_class_count = 16;
+// Reserved on first use; untouched pages are never committed.
+constexpr uint64_t region_size = 64 * 1024 * 1024;
+
+// linkonce_odr, so that modules linked from the cache share one set of pools.
+llvm::GlobalVariable* get_pool_global(ModuleCompiler& compiler, const char* name, llvm::Type* type)
+{
+    auto* module = compiler.get_module();
+    if (auto* existing = module->getNamedGlobal(name)) return existing;
+
+    return new llvm::GlobalVariable(*module, type, false, llvm::GlobalValue::LinkOnceODRLinkage,
+                                    llvm::Constant::getNullValue(type), name);
+}
+
+llvm::GlobalVariable* get_free_lists(ModuleCompiler& compiler)
+{
+    auto* ptr_type = llvm::PointerType::get(compiler.get_context(), 0);
+    return get_pool_global(compiler, "__kyoto_pool_free_lists", llvm::ArrayType::get(ptr_type, size_class_count));
+}
+
+llvm::Value* gen_free_list_slot(ModuleCompiler& compiler, llvm::IRBuilder<>& builder, llvm::Value* block_size)
+{
+    auto* free_lists = get_free_lists(compiler);
+    auto* index = builder.CreateSub(builder.CreateUDiv(block_size, builder.getInt64(size_class_granularity)),
+                                    builder.getInt64(1), "size_class");
+    return builder.CreateGEP(free_lists->getValueType(), free_lists, { builder.getInt64(0), index }, "free_list");
+}
+
+// Pops the size class's free list, or bumps a new block off the region, or falls back to malloc once the region is
+// used up.
+llvm::Function* get_pool_alloc_fn(ModuleCompiler& compiler)
+{
+    constexpr auto* name = "__kyoto_pool_alloc";
+    auto* module = compiler.get_module();
+    if (auto* existing = module->getFunction(name)) return existing;
+
+    auto& context = compiler.get_context();
+    auto* ptr_type = llvm::PointerType::get(context, 0);
+    auto* i64_type = llvm::Type::getInt64Ty(context);
+    auto* function = declare_runtime_function(compiler, name, llvm::FunctionType::get(ptr_type, { i64_type }, false));
+    auto* size = function->getArg(0);
+    auto* malloc_fn = module->getFunction("malloc");
+
+    auto* region_begin = get_pool_global(compiler, "__kyoto_pool_region_begin", ptr_type);
+    auto* region_next = get_pool_global(compiler, "__kyoto_pool_region_next", ptr_type);
+    auto* region_end = get_pool_global(compiler, "__kyoto_pool_region_end", ptr_type);
+
+    auto* entry = llvm::BasicBlock::Create(context, "entry", function);
+    auto* reuse = llvm::BasicBlock::Create(context, "reuse", function);
+    auto* bump = llvm::BasicBlock::Create(context, "bump", function);
+    auto* reserve = llvm::BasicBlock::Create(context, "reserve", function);
+    auto* reserved = llvm::BasicBlock::Create(context, "reserved", function);
+    auto* carve = llvm::BasicBlock::Create(context, "carve", function);
+    auto* take = llvm::BasicBlock::Create(context, "take", function);
+    auto* fallback = llvm::BasicBlock::Create(context, "fallback", function);
+
+    llvm::IRBuilder<> builder(entry);
+    auto* slot = gen_free_list_slot(compiler, builder, size);
+    auto* head = builder.CreateLoad(ptr_type, slot, "head");
+    builder.CreateCondBr(builder.CreateIsNull(head), bump, reuse);
+
+    builder.SetInsertPoint(reuse);
+    builder.CreateStore(builder.CreateLoad(ptr_type, head, "next"), slot);
+    builder.CreateRet(head);
+
+    builder.SetInsertPoint(bump);
+    auto* next = builder.CreateLoad(ptr_type, region_next, "region_next");
+    builder.CreateCondBr(builder.CreateIsNull(next), reserve, carve);
+
+    builder.SetInsertPoint(reserve);
+    auto* region = builder.CreateCall(malloc_fn, { builder.getInt64(region_size) }, "region");
+    builder.CreateCondBr(builder.CreateIsNull(region), fallback, reserved);
+
+    builder.SetInsertPoint(reserved);
+    builder.CreateStore(region, region_begin);
+    builder.CreateStore(builder.CreateGEP(builder.getInt8Ty(), region, builder.getInt64(region_size)), region_end);
+    builder.CreateBr(carve);
+
+    builder.SetInsertPoint(carve);
+    auto* block = builder.CreatePHI(ptr_type, 2, "block");
+    block->addIncoming(next, bump);
+    block->addIncoming(region, reserved);
+    auto* end = builder.CreateLoad(ptr_type, region_end, "region_end");
+    auto* available = builder.CreateSub(builder.CreatePtrToInt(end, i64_type), builder.CreatePtrToInt(block, i64_type));
+    builder.CreateCondBr(builder.CreateICmpULE(size, available), take, fallback);
+
+    builder.SetInsertPoint(take);
+    builder.CreateStore(builder.CreateGEP(builder.getInt8Ty(), block, size), region_next);
+    builder.CreateRet(block);
+
+    builder.SetInsertPoint(fallback);
+    builder.CreateRet(builder.CreateCall(malloc_fn, { size }));
+    return function;
+}
+
+// Pushes blocks of the region onto their size class's free list and frees anything else.
+llvm::Function* get_pool_free_fn(ModuleCompiler& compiler)
+{
+    auto* module = compiler.get_module();
+    if (auto* existing = module->getFunction(pool_free_function)) return existing;
+
+    auto& context = compiler.get_context();
+    auto* ptr_type = llvm::PointerType::get(context, 0);
+    auto* i64_type = llvm::Type::getInt64Ty(context);
+    auto* type = llvm::FunctionType::get(llvm::Type::getVoidTy(context), { ptr_type, i64_type }, false);
+    auto* function = declare_runtime_function(compiler, pool_free_function, type);
+    auto* ptr = function->getArg(0);
+    auto* size = function->getArg(1);
+
+    auto* region_begin = get_pool_global(compiler, "__kyoto_pool_region_begin", ptr_type);
+    auto* region_end = get_pool_global(compiler, "__kyoto_pool_region_end", ptr_type);
+
+    auto* entry = llvm::BasicBlock::Create(context, "entry", function);
+    auto* push = llvm::BasicBlock::Create(context, "push", function);
+    auto* release = llvm::BasicBlock::Create(context, "release", function);
+
+    llvm::IRBuilder<> builder(entry);
+    auto* address = builder.CreatePtrToInt(ptr, i64_type);
+    auto* begin = builder.CreatePtrToInt(builder.CreateLoad(ptr_type, region_begin), i64_type);
+    auto* end = builder.CreatePtrToInt(builder.CreateLoad(ptr_type, region_end), i64_type);
+    auto* in_region = builder.CreateAnd(builder.CreateICmpUGE(address, begin), builder.CreateICmpULT(address, end));
+    builder.CreateCondBr(in_region, push, release);
+
+    builder.SetInsertPoint(push);
+    auto* slot = gen_free_list_slot(compiler, builder, size);
+    builder.CreateStore(builder.CreateLoad(ptr_type, slot, "head"), ptr);
+    builder.CreateStore(ptr, slot);
+    builder.CreateRetVoid();
+
+    builder.SetInsertPoint(release);
+    builder.CreateCall(module->getFunction("free"), { ptr });
+    builder.CreateRetVoid();
+    return function;
+}
+
+}
+
+uint64_t get_pool_block_size(uint64_t size)
+{
+    const auto block_size = (size + size_class_granularity - 1) / size_class_granularity * size_class_granularity;
+    if (block_size == 0) return size_class_granularity;
+    return block_size <= size_class_granularity * size_class_count ? block_size : 0;
+}
+
+llvm::Value* gen_pool_alloc(ModuleCompiler& compiler, uint64_t block_size)
+{
+    auto& builder = compiler.get_builder();
+    return builder.CreateCall(get_pool_alloc_fn(compiler), { builder.getInt64(block_size) });
+}
+
+void gen_pool_free(ModuleCompiler& compiler, llvm::Value* ptr, uint64_t block_size)
+{
+    auto& builder = compiler.get_builder();
+    builder.CreateCall(get_pool_free_fn(compiler), { ptr, builder.getInt64(block_size) });
+}
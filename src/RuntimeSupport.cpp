@@ -0,0 +1,53 @@
+#include "kyoto/RuntimeSupport.h"
+
+#include "kyoto/CompilerOptions.h"
+#include "kyoto/ModuleCompiler.h"
+#include "llvm/IR/Attributes.h"
+#include "llvm/IR/BasicBlock.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Intrinsics.h"
+#include "llvm/IR/Module.h"
+
+llvm::Function* declare_runtime_function(ModuleCompiler& compiler, const char* name, llvm::FunctionType* type)
+{
+    auto* function = llvm::Function::Create(type, llvm::Function::PrivateLinkage, name, compiler.get_module());
+    function->addFnAttr(llvm::Attribute::NoUnwind);
+    return function;
+}
+
+llvm::Function* get_runtime_error_handler(ModuleCompiler& compiler, const char* name, const char* message)
+{
+    auto* module = compiler.get_module();
+    if (auto* existing = module->getFunction(name)) return existing;
+
+    auto& context = compiler.get_context();
+    auto* handler_type = llvm::FunctionType::get(llvm::Type::getVoidTy(context), false);
+    auto* handler = declare_runtime_function(compiler, name, handler_type);
+    handler->addFnAttr(llvm::Attribute::NoInline);
+    handler->addFnAttr(llvm::Attribute::Cold);
+    handler->addFnAttr(llvm::Attribute::NoReturn);
+
+    llvm::IRBuilder<> builder(llvm::BasicBlock::Create(context, "entry", handler));
+    auto* ptr_type = llvm::PointerType::get(context, 0);
+    auto* puts_type = llvm::FunctionType::get(llvm::Type::getInt32Ty(context), { ptr_type }, false);
+    builder.CreateCall(module->getOrInsertFunction("puts", puts_type), { compiler.get_string_constant(message) });
+    auto* fflush_type = llvm::FunctionType::get(llvm::Type::getInt32Ty(context), { ptr_type }, false);
+    auto fflush_fn = module->getOrInsertFunction("fflush", fflush_type);
+    builder.CreateCall(fflush_fn, { llvm::ConstantPointerNull::get(ptr_type) });
+    builder.CreateCall(llvm::Intrinsic::getOrInsertDeclaration(module, llvm::Intrinsic::trap));
+    builder.CreateUnreachable();
+
+    return handler;
+}
+
+void gen_runtime_error(ModuleCompiler& compiler, llvm::IRBuilder<>& builder, const char* name, const char* message)
+{
+    if (compiler.get_options().bounds_checks == BoundsCheckMode::TrapOnly) {
+        builder.CreateCall(llvm::Intrinsic::getOrInsertDeclaration(compiler.get_module(), llvm::Intrinsic::trap));
+    } else {
+        builder.CreateCall(get_runtime_error_handler(compiler, name, message));
+    }
+    builder.CreateUnreachable();
+}
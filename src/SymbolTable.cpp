@@ -1,53 +1,67 @@
 #include <cstddef>
-#include <map>
 #include <optional>
-#include <ranges>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "kyoto/KType.h"
 #include "kyoto/SymbolTable.h"
+#include "kyoto/TypeContext.h"
 
 namespace llvm {
 class AllocaInst;
 }
 
-void Scope::add_symbol(const std::string& name, const Symbol& value)
-{
-    symbols.insert_or_assign(name, value);
-}
-
-std::optional<Symbol> Scope::get_symbol(const std::string& name)
-{
-    return symbols.contains(name) ? std::optional { symbols[name] } : std::nullopt;
-}
-
 SymbolTable::SymbolTable() { }
 
 void SymbolTable::push_scope()
 {
-    scopes.push_back(Scope {});
+    scopes.emplace_back();
 }
 
 void SymbolTable::pop_scope()
 {
+    for (const auto id : scopes.back()) {
+        bindings[id].pop_back();
+    }
     scopes.pop_back();
 }
 
+SymbolTable::SymbolId SymbolTable::intern(const std::string& name)
+{
+    const auto [it, inserted] = ids.try_emplace(name, static_cast<SymbolId>(bindings.size()));
+    if (inserted) bindings.emplace_back();
+    return it->second;
+}
+
 void SymbolTable::add_symbol(const std::string& name, Symbol symbol)
 {
-    scopes.back().add_symbol(name, std::move(symbol));
+    add_symbol(intern(name), std::move(symbol));
 }
 
-std::optional<Symbol> SymbolTable::get_symbol(const std::string& name)
+void SymbolTable::add_symbol(SymbolId id, Symbol symbol)
 {
-    for (auto& scope : std::ranges::views::reverse(scopes)) {
-        if (auto symbol = scope.get_symbol(name); symbol.has_value()) {
-            return symbol.value();
-        }
+    // Redeclaring a name in the same scope replaces its binding rather than shadowing it.
+    auto& stack = bindings[id];
+    if (!stack.empty() && stack.back().depth == scopes.size()) {
+        stack.back().symbol = std::move(symbol);
+        return;
     }
-    return std::nullopt;
+
+    stack.push_back({ std::move(symbol), scopes.size() });
+    scopes.back().push_back(id);
+}
+
+std::optional<Symbol> SymbolTable::get_symbol(const std::string& name) const
+{
+    const auto it = ids.find(name);
+    return it == ids.end() ? std::nullopt : get_symbol(it->second);
+}
+
+std::optional<Symbol> SymbolTable::get_symbol(SymbolId id) const
+{
+    const auto& stack = bindings[id];
+    return stack.empty() ? std::nullopt : std::optional { stack.back().symbol };
 }
 
 size_t SymbolTable::n_scopes() const
@@ -55,9 +69,9 @@ size_t SymbolTable::n_scopes() const
     return scopes.size();
 }
 
-Symbol Symbol::primitive(llvm::AllocaInst* value, PrimitiveType::Kind kind)
+Symbol Symbol::primitive(llvm::AllocaInst* value, PrimitiveType::Kind kind, TypeContext& types)
 {
-    return Symbol(value, new PrimitiveType(kind));
+    return Symbol(value, types.primitive(kind));
 }
 
 Symbol::Symbol(llvm::AllocaInst* value, KType* type)
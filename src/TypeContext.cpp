@@ -0,0 +1,131 @@
+#include "kyoto/TypeContext.h"
+
+#include <assert.h>
+#include <format>
+#include <ranges>
+#include <stdexcept>
+
+#include "llvm/Support/Casting.h"
+
+TypeContext::~TypeContext()
+{
+    // Composite types are adopted after their components, so tearing down in reverse lets each destructor still see
+    // its (interned, hence untouched) components alive.
+    for (auto* type : std::views::reverse(owned)) {
+        type->interned = false;
+        delete type;
+    }
+}
+
+template <typename T> T* TypeContext::adopt(T* type)
+{
+    type->interned = true;
+    owned.push_back(type);
+    return type;
+}
+
+PrimitiveType* TypeContext::primitive(PrimitiveType::Kind kind)
+{
+    auto& slot = primitives[static_cast<size_t>(kind)];
+    if (!slot) slot = adopt(new PrimitiveType(kind));
+    return slot;
+}
+
+PointerType* TypeContext::pointer(const KType* pointee)
+{
+    auto* canonical = intern(pointee);
+    auto& slot = pointers[canonical];
+    if (!slot) slot = adopt(new PointerType(canonical));
+    return slot;
+}
+
+ClassType* TypeContext::class_type(const std::string& name)
+{
+    auto& slot = classes[name];
+    if (!slot) slot = adopt(new ClassType(name));
+    return slot;
+}
+
+ArrayType* TypeContext::array(const KType* element_type, size_t n)
+{
+    auto* canonical = intern(element_type);
+    auto& slot = arrays[{ canonical, n }];
+    if (!slot) slot = adopt(new ArrayType(canonical, n));
+    return slot;
+}
+
+SliceType* TypeContext::slice(const KType* element_type)
+{
+    auto* canonical = intern(element_type);
+    auto& slot = slices[canonical];
+    if (!slot) slot = adopt(new SliceType(canonical));
+    return slot;
+}
+
+VectorType* TypeContext::vector(const KType* element_type, size_t lanes)
+{
+    auto* canonical = intern(element_type);
+    auto& slot = vectors[{ canonical, lanes }];
+    if (!slot) slot = adopt(new VectorType(canonical, lanes));
+    return slot;
+}
+
+FunctionType* TypeContext::function(const std::vector<KType*>& param_types, const KType* return_type)
+{
+    std::vector<KType*> canonical_params;
+    std::vector<const KType*> key;
+    canonical_params.reserve(param_types.size());
+    key.reserve(param_types.size() + 1);
+    for (const auto* param_type : param_types) {
+        canonical_params.push_back(intern(param_type));
+        key.push_back(canonical_params.back());
+    }
+    auto* canonical_return = intern(return_type);
+    key.push_back(canonical_return);
+
+    auto& slot = functions[key];
+    if (!slot) slot = adopt(new FunctionType(std::move(canonical_params), canonical_return));
+    return slot;
+}
+
+KType* TypeContext::intern(const KType* type)
+{
+    if (type->is_interned()) return const_cast<KType*>(type);
+
+    if (type->is_pointer()) return pointer(type->as<PointerType>()->get_pointee());
+    if (type->is_class()) return class_type(type->get_class_name());
+    if (type->is_slice()) return slice(type->as<SliceType>()->get_element_type());
+
+    if (type->is_array()) {
+        const auto* array_type = type->as<ArrayType>();
+        return array(array_type->get_element_type(), array_type->get_size());
+    }
+
+    if (type->is_vector()) {
+        const auto* vector_type = type->as<VectorType>();
+        return vector(vector_type->get_element_type(), vector_type->get_lanes());
+    }
+
+    if (type->is_function()) {
+        const auto* function_type = type->as<FunctionType>();
+        return function(function_type->get_param_types(), function_type->get_return_type());
+    }
+
+    if (const auto* primitive_type = llvm::dyn_cast<PrimitiveType>(type)) {
+        return primitive(primitive_type->get_kind());
+    }
+
+    throw std::runtime_error(std::format("TypeContext::intern: unsupported type `{}`", type->to_string()));
+}
+
+llvm::Type* TypeContext::get_llvm_type(const KType* type) const
+{
+    const auto it = llvm_types.find(type);
+    return it == llvm_types.end() ? nullptr : it->second;
+}
+
+void TypeContext::cache_llvm_type(const KType* type, llvm::Type* llvm_type)
+{
+    assert(type->is_interned());
+    llvm_types[type] = llvm_type;
+}
@@ -27,6 +27,19 @@ std::optional<PrimitiveType::Kind> TypeResolver::resolve_binary_logical(const Pr
     return std::nullopt;
 }
 
+const VectorType* TypeResolver::resolve_vector_arith(const KType* lhs, const KType* rhs) const
+{
+    const auto* vector_type = resolve_vector_cmp(lhs, rhs);
+    if (!vector_type || vector_type->get_element_type()->is_boolean()) return nullptr;
+    return vector_type;
+}
+
+const VectorType* TypeResolver::resolve_vector_cmp(const KType* lhs, const KType* rhs) const
+{
+    if (!lhs->is_vector() || !rhs->is_vector() || *lhs != *rhs) return nullptr;
+    return lhs->as<VectorType>();
+}
+
 bool TypeResolver::promotable_to(const PrimitiveType::Kind from, const PrimitiveType::Kind to) const
 {
     auto pfrom = PrimitiveType(from);
@@ -1,6 +1,6 @@
-#include <Token.h>
 #include <algorithm>
 #include <any>
+#include <bit>
 #include <format>
 #include <initializer_list>
 #include <optional>
@@ -9,10 +9,12 @@
 #include <stdexcept>
 #include <stdint.h>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "KyotoParser.h"
 #include "kyoto/AST/ASTNode.h"
+#include "kyoto/AST/ArenaStatementNode.h"
 #include "kyoto/AST/ClassDefinitionNode.h"
 #include "kyoto/AST/DeclarationNodes.h"
 #include "kyoto/AST/Expressions/AnonymousFunctionNode.h"
@@ -44,9 +46,23 @@
 #include "kyoto/TypeResolver.h"
 #include "kyoto/Visitor.h"
 #include "tree/TerminalNode.h"
+#include "llvm/Support/Casting.h"
 
-ASTBuilderVisitor::ASTBuilderVisitor(ModuleCompiler& compiler)
+namespace {
+
+// Names shaped like a vector type whose lane count the lexer does not accept.
+bool is_unsupported_vector_type_name(const std::string& name)
+{
+    static const std::regex vector_type_name(R"((bool|i8|i16|i32|i64|f32|f64)x[0-9]+)");
+    return std::regex_match(name, vector_type_name);
+}
+
+}
+
+ASTBuilderVisitor::ASTBuilderVisitor(ModuleCompiler& compiler, const TemplateInstance* instance)
     : compiler(compiler)
+    , arena(compiler.get_ast_arena())
+    , instance(instance)
 {
 }
 
@@ -68,7 +84,7 @@ std::any ASTBuilderVisitor::visitProgram(kyoto::KyotoParser::ProgramContext* ctx
         i++;
     }
 
-    return (ASTNode*)new ProgramNode(nodes, compiler);
+    return (ASTNode*)make<ProgramNode>(nodes, compiler);
 }
 
 std::any ASTBuilderVisitor::visitImportStatement(kyoto::KyotoParser::ImportStatementContext* ctx)
@@ -89,7 +105,7 @@ std::any ASTBuilderVisitor::visitCdecl(kyoto::KyotoParser::CdeclContext* ctx)
     auto* ret_type = std::any_cast<KType*>(visit(ctx->type()));
     const auto varargs = ctx->parameterList()->ELLIPSIS() != nullptr;
     auto* proto
-        = new FunctionNode(name, args, varargs, ret_type, nullptr, compiler, /* is_external = */ true, external_name);
+        = make<FunctionNode>(name, args, varargs, ret_type, nullptr, compiler, /* is_external = */ true, external_name);
     compiler.add_function(proto);
     return (ASTNode*)proto;
 }
@@ -118,7 +134,7 @@ std::any ASTBuilderVisitor::visitFunctionDefinition(kyoto::KyotoParser::Function
     if (varargs) {
         throw std::runtime_error("Variadic functions are only supported for cdecl declarations");
     }
-    auto* proto = new FunctionNode(name, args, varargs, ret_type, nullptr, compiler, false, linkage_name);
+    auto* proto = make<FunctionNode>(name, args, varargs, ret_type, nullptr, compiler, false, linkage_name);
     compiler.add_function(proto);
 
     compiler.push_type_alias_scope();
@@ -154,20 +170,20 @@ std::any ASTBuilderVisitor::visitBlock(kyoto::KyotoParser::BlockContext* ctx)
 
     compiler.pop_type_alias_scope();
 
-    return (ASTNode*)new BlockNode(nodes, compiler);
+    return (ASTNode*)make<BlockNode>(nodes, compiler);
 }
 
 std::any ASTBuilderVisitor::visitExpressionStatement(kyoto::KyotoParser::ExpressionStatementContext* ctx)
 {
     auto* expr = std::any_cast<ExpressionNode*>(visit(ctx->expression()));
-    return (ASTNode*)new ExpressionStatementNode(expr, compiler);
+    return (ASTNode*)make<ExpressionStatementNode>(expr, compiler);
 }
 
 std::any ASTBuilderVisitor::visitDeclaration(kyoto::KyotoParser::DeclarationContext* ctx)
 {
     auto* type = std::any_cast<KType*>(visit(ctx->type()));
     std::string name = ctx->IDENTIFIER()->getText();
-    return (ASTNode*)new DeclarationStatementNode(name, type, compiler);
+    return (ASTNode*)make<DeclarationStatementNode>(name, type, compiler);
 }
 
 std::any ASTBuilderVisitor::visitRegularDeclaration(kyoto::KyotoParser::RegularDeclarationContext* ctx)
@@ -177,40 +193,46 @@ std::any ASTBuilderVisitor::visitRegularDeclaration(kyoto::KyotoParser::RegularD
     auto* expr = std::any_cast<ExpressionNode*>(visit(ctx->expression()));
     if (type->is_array() && expr->get_ktype()->is_array())
         type->as<ArrayType>()->set_size(expr->get_ktype()->as<ArrayType>()->get_size());
-    return (ASTNode*)new FullDeclarationStatementNode(name, type, expr, compiler);
+    return (ASTNode*)make<FullDeclarationStatementNode>(name, type, expr, compiler);
 }
 
 std::any ASTBuilderVisitor::visitTypelessDeclaration(kyoto::KyotoParser::TypelessDeclarationContext* ctx)
 {
     std::string name = ctx->IDENTIFIER()->getText();
     auto* expr = std::any_cast<ExpressionNode*>(visit(ctx->expression()));
-    return (ASTNode*)new FullDeclarationStatementNode(name, nullptr, expr, compiler);
+    return (ASTNode*)make<FullDeclarationStatementNode>(name, nullptr, expr, compiler);
 }
 
 std::any ASTBuilderVisitor::visitTypeAliasStatement(kyoto::KyotoParser::TypeAliasStatementContext* ctx)
 {
     auto* original_type = std::any_cast<KType*>(visit(ctx->type()));
     std::string alias = ctx->IDENTIFIER()->getText();
-    return (ASTNode*)new TypeAliasNode(original_type, alias, compiler);
+    return (ASTNode*)make<TypeAliasNode>(original_type, alias, compiler);
 }
 
 std::any ASTBuilderVisitor::visitAssignmentExpression(kyoto::KyotoParser::AssignmentExpressionContext* ctx)
 {
     const auto assignee = std::any_cast<ExpressionNode*>(visit(ctx->expression(0)));
     auto* expr = std::any_cast<ExpressionNode*>(visit(ctx->expression(1)));
-    return (ExpressionNode*)new AssignmentNode(assignee, expr, compiler);
+    return (ExpressionNode*)make<AssignmentNode>(assignee, expr, compiler);
 }
 
 std::any ASTBuilderVisitor::visitReturnStatement(kyoto::KyotoParser::ReturnStatementContext* ctx)
 {
     auto* expr = ctx->expression() ? std::any_cast<ExpressionNode*>(visit(ctx->expression())) : nullptr;
-    return (ASTNode*)new ReturnStatementNode(expr, compiler);
+    return (ASTNode*)make<ReturnStatementNode>(expr, compiler);
 }
 
 std::any ASTBuilderVisitor::visitFreeStatement(kyoto::KyotoParser::FreeStatementContext* ctx)
 {
     auto* expr = std::any_cast<ExpressionNode*>(visit(ctx->expression()));
-    return (ASTNode*)new FreeStatementNode(expr, compiler);
+    return (ASTNode*)make<FreeStatementNode>(expr, compiler);
+}
+
+std::any ASTBuilderVisitor::visitArenaStatement(kyoto::KyotoParser::ArenaStatementContext* ctx)
+{
+    auto* body = std::any_cast<ASTNode*>(visit(ctx->block()));
+    return (ASTNode*)make<ArenaStatementNode>(body, compiler);
 }
 
 std::any ASTBuilderVisitor::visitFunctionCallExpression(kyoto::KyotoParser::FunctionCallExpressionContext* ctx)
@@ -223,7 +245,7 @@ std::any ASTBuilderVisitor::visitFunctionCallExpression(kyoto::KyotoParser::Func
             args.push_back(std::any_cast<ExpressionNode*>(visit(arg)));
         }
     }
-    return (ExpressionNode*)new FunctionCall(name, args, compiler);
+    return (ExpressionNode*)make<FunctionCall>(name, args, compiler);
 }
 
 std::any
@@ -236,7 +258,7 @@ ASTBuilderVisitor::visitIndirectFunctionCallExpression(kyoto::KyotoParser::Indir
             args.push_back(std::any_cast<ExpressionNode*>(visit(arg)));
         }
     }
-    return (ExpressionNode*)new FunctionCall(callee, args, compiler);
+    return (ExpressionNode*)make<FunctionCall>(callee, args, compiler);
 }
 
 std::any
@@ -250,7 +272,7 @@ ASTBuilderVisitor::visitQualifiedFunctionCallExpression(kyoto::KyotoParser::Qual
             args.push_back(std::any_cast<ExpressionNode*>(visit(arg)));
         }
     }
-    return (ExpressionNode*)new FunctionCall(name, args, compiler);
+    return (ExpressionNode*)make<FunctionCall>(name, args, compiler);
 }
 
 std::any
@@ -270,24 +292,24 @@ ASTBuilderVisitor::visitAnonymousFunctionExpression(kyoto::KyotoParser::Anonymou
 
     const auto anon_name
         = compiler.qualify_local_name("__anon_fn_" + std::to_string(compiler.get_instantiated_nodes().size()));
-    auto* function = new FunctionNode(anon_name, args, false, ret_type, body, compiler, false, anon_name);
+    auto* function = make<FunctionNode>(anon_name, args, false, ret_type, body, compiler, false, anon_name);
     compiler.add_function(function);
     compiler.get_instantiated_nodes().push_back(function);
 
-    auto* function_type = new FunctionType(std::move(param_types), ret_type->copy());
-    return (ExpressionNode*)new AnonymousFunctionNode(function, function_type, compiler);
+    auto* function_type = make<FunctionType>(std::move(param_types), ret_type->copy());
+    return (ExpressionNode*)make<AnonymousFunctionNode>(function, function_type, compiler);
 }
 
 std::any ASTBuilderVisitor::visitStringExpression(kyoto::KyotoParser::StringExpressionContext* ctx)
 {
     const auto txt = std::regex_replace(ctx->getText(), std::regex(R"(\\n)"), "\n");
-    return (ExpressionNode*)new StringLiteralNode(txt.substr(1, txt.size() - 2), compiler);
+    return (ExpressionNode*)make<StringLiteralNode>(txt.substr(1, txt.size() - 2), compiler);
 }
 
 std::any ASTBuilderVisitor::visitCharExpression(kyoto::KyotoParser::CharExpressionContext* ctx)
 {
     const auto txt = ctx->getText();
-    return (ExpressionNode*)new NumberNode(txt[1], new PrimitiveType(PrimitiveType::Kind::Char), compiler);
+    return (ExpressionNode*)make<NumberNode>(txt[1], make<PrimitiveType>(PrimitiveType::Kind::Char), compiler);
 }
 
 std::any ASTBuilderVisitor::visitNumberExpression(kyoto::KyotoParser::NumberExpressionContext* ctx)
@@ -300,7 +322,7 @@ std::any ASTBuilderVisitor::visitNumberExpression(kyoto::KyotoParser::NumberExpr
     using Kind = PrimitiveType::Kind;
     for (const auto kind : { Kind::I32, Kind::I64, Kind::Boolean }) {
         if (auto num = parse_signed_integer_into(txt, kind); num.has_value())
-            return (ExpressionNode*)new NumberNode(num.value(), new PrimitiveType(kind), compiler);
+            return (ExpressionNode*)make<NumberNode>(num.value(), make<PrimitiveType>(kind), compiler);
     }
 
     throw std::runtime_error(std::format("Failed to parse number literal: `{}`", txt));
@@ -308,26 +330,26 @@ std::any ASTBuilderVisitor::visitNumberExpression(kyoto::KyotoParser::NumberExpr
 
 std::any ASTBuilderVisitor::visitIdentifierExpression(kyoto::KyotoParser::IdentifierExpressionContext* ctx)
 {
-    return (ExpressionNode*)new IdentifierExpressionNode(ctx->IDENTIFIER()->getText(), compiler);
+    return (ExpressionNode*)make<IdentifierExpressionNode>(ctx->IDENTIFIER()->getText(), compiler);
 }
 
 std::any ASTBuilderVisitor::visitAddressOfExpression(kyoto::KyotoParser::AddressOfExpressionContext* ctx)
 {
     auto* expr = std::any_cast<ExpressionNode*>(visit(ctx->expression()));
-    return (ExpressionNode*)new UnaryNode(expr, UnaryNode::UnaryOp::AddressOf, compiler);
+    return (ExpressionNode*)make<UnaryNode>(expr, UnaryNode::UnaryOp::AddressOf, compiler);
 }
 
 std::any ASTBuilderVisitor::visitDereferenceExpression(kyoto::KyotoParser::DereferenceExpressionContext* ctx)
 {
     auto* expr = std::any_cast<ExpressionNode*>(visit(ctx->expression()));
-    return (ExpressionNode*)new UnaryNode(expr, UnaryNode::UnaryOp::Dereference, compiler);
+    return (ExpressionNode*)make<UnaryNode>(expr, UnaryNode::UnaryOp::Dereference, compiler);
 }
 
 std::any ASTBuilderVisitor::visitMemberAccessExpression(kyoto::KyotoParser::MemberAccessExpressionContext* ctx)
 {
     auto* lhs = std::any_cast<ExpressionNode*>(visit(ctx->expression()));
     const auto member = ctx->IDENTIFIER()->getText();
-    return (ExpressionNode*)new MemberAccessNode(lhs, member, compiler);
+    return (ExpressionNode*)make<MemberAccessNode>(lhs, member, compiler);
 }
 
 std::any ASTBuilderVisitor::visitMethodCallExpression(kyoto::KyotoParser::MethodCallExpressionContext* ctx)
@@ -339,93 +361,93 @@ std::any ASTBuilderVisitor::visitMethodCallExpression(kyoto::KyotoParser::Method
     for (const auto arg : ctx->expressionList()->expression()) {
         args.push_back(std::any_cast<ExpressionNode*>(visit(arg)));
     }
-    return (ExpressionNode*)new MethodCall(instance, instance_name, name, args, compiler);
+    return (ExpressionNode*)make<MethodCall>(instance, instance_name, name, args, compiler);
 }
 
 std::any ASTBuilderVisitor::visitPrefixIncrementExpression(kyoto::KyotoParser::PrefixIncrementExpressionContext* ctx)
 {
     auto* expr = std::any_cast<ExpressionNode*>(visit(ctx->expression()));
-    return (ExpressionNode*)new UnaryNode(expr, UnaryNode::UnaryOp::PrefixIncrement, compiler);
+    return (ExpressionNode*)make<UnaryNode>(expr, UnaryNode::UnaryOp::PrefixIncrement, compiler);
 }
 
 std::any ASTBuilderVisitor::visitPrefixDecrementExpression(kyoto::KyotoParser::PrefixDecrementExpressionContext* ctx)
 {
     auto* expr = std::any_cast<ExpressionNode*>(visit(ctx->expression()));
-    return (ExpressionNode*)new UnaryNode(expr, UnaryNode::UnaryOp::PrefixDecrement, compiler);
+    return (ExpressionNode*)make<UnaryNode>(expr, UnaryNode::UnaryOp::PrefixDecrement, compiler);
 }
 
 std::any ASTBuilderVisitor::visitNegationExpression(kyoto::KyotoParser::NegationExpressionContext* ctx)
 {
     auto* expr = std::any_cast<ExpressionNode*>(visit(ctx->expression()));
-    return (ExpressionNode*)new UnaryNode(expr, UnaryNode::UnaryOp::Negate, compiler);
+    return (ExpressionNode*)make<UnaryNode>(expr, UnaryNode::UnaryOp::Negate, compiler);
 }
 
 std::any ASTBuilderVisitor::visitPositiveExpression(kyoto::KyotoParser::PositiveExpressionContext* ctx)
 {
     auto* expr = std::any_cast<ExpressionNode*>(visit(ctx->expression()));
-    return (ExpressionNode*)new UnaryNode(expr, UnaryNode::UnaryOp::Positive, compiler);
+    return (ExpressionNode*)make<UnaryNode>(expr, UnaryNode::UnaryOp::Positive, compiler);
 }
 
 std::any ASTBuilderVisitor::visitNotExpression(kyoto::KyotoParser::NotExpressionContext* ctx)
 {
     auto* expr = std::any_cast<ExpressionNode*>(visit(ctx->expression()));
-    return (ExpressionNode*)new UnaryNode(expr, UnaryNode::UnaryOp::LogicalNot, compiler);
+    return (ExpressionNode*)make<UnaryNode>(expr, UnaryNode::UnaryOp::LogicalNot, compiler);
 }
 
 std::any ASTBuilderVisitor::visitMultiplicationExpression(kyoto::KyotoParser::MultiplicationExpressionContext* ctx)
 {
     auto* lhs = std::any_cast<ExpressionNode*>(visit(ctx->children[0]));
     auto* rhs = std::any_cast<ExpressionNode*>(visit(ctx->children[2]));
-    return (ExpressionNode*)new MulNode(lhs, rhs, compiler);
+    return (ExpressionNode*)make<MulNode>(lhs, rhs, compiler);
 }
 
 std::any ASTBuilderVisitor::visitDivisionExpression(kyoto::KyotoParser::DivisionExpressionContext* ctx)
 {
     auto* lhs = std::any_cast<ExpressionNode*>(visit(ctx->children[0]));
     auto* rhs = std::any_cast<ExpressionNode*>(visit(ctx->children[2]));
-    return (ExpressionNode*)new DivNode(lhs, rhs, compiler);
+    return (ExpressionNode*)make<DivNode>(lhs, rhs, compiler);
 }
 
 std::any ASTBuilderVisitor::visitModulusExpression(kyoto::KyotoParser::ModulusExpressionContext* ctx)
 {
     auto* lhs = std::any_cast<ExpressionNode*>(visit(ctx->children[0]));
     auto* rhs = std::any_cast<ExpressionNode*>(visit(ctx->children[2]));
-    return (ExpressionNode*)new ModNode(lhs, rhs, compiler);
+    return (ExpressionNode*)make<ModNode>(lhs, rhs, compiler);
 }
 
 std::any ASTBuilderVisitor::visitAdditionExpression(kyoto::KyotoParser::AdditionExpressionContext* ctx)
 {
     auto* lhs = std::any_cast<ExpressionNode*>(visit(ctx->children[0]));
     auto* rhs = std::any_cast<ExpressionNode*>(visit(ctx->children[2]));
-    return (ExpressionNode*)new AddNode(lhs, rhs, compiler);
+    return (ExpressionNode*)make<AddNode>(lhs, rhs, compiler);
 }
 
 std::any ASTBuilderVisitor::visitSubtractionExpression(kyoto::KyotoParser::SubtractionExpressionContext* ctx)
 {
     auto* lhs = std::any_cast<ExpressionNode*>(visit(ctx->children[0]));
     auto* rhs = std::any_cast<ExpressionNode*>(visit(ctx->children[2]));
-    return (ExpressionNode*)new SubNode(lhs, rhs, compiler);
+    return (ExpressionNode*)make<SubNode>(lhs, rhs, compiler);
 }
 
 std::any ASTBuilderVisitor::visitLessThanExpression(kyoto::KyotoParser::LessThanExpressionContext* ctx)
 {
     auto* lhs = std::any_cast<ExpressionNode*>(visit(ctx->children[0]));
     auto* rhs = std::any_cast<ExpressionNode*>(visit(ctx->children[2]));
-    return (ExpressionNode*)new LessNode(lhs, rhs, compiler);
+    return (ExpressionNode*)make<LessNode>(lhs, rhs, compiler);
 }
 
 std::any ASTBuilderVisitor::visitGreaterThanExpression(kyoto::KyotoParser::GreaterThanExpressionContext* ctx)
 {
     auto* lhs = std::any_cast<ExpressionNode*>(visit(ctx->children[0]));
     auto* rhs = std::any_cast<ExpressionNode*>(visit(ctx->children[2]));
-    return (ExpressionNode*)new GreaterNode(lhs, rhs, compiler);
+    return (ExpressionNode*)make<GreaterNode>(lhs, rhs, compiler);
 }
 
 std::any ASTBuilderVisitor::visitLessThanOrEqualExpression(kyoto::KyotoParser::LessThanOrEqualExpressionContext* ctx)
 {
     auto* lhs = std::any_cast<ExpressionNode*>(visit(ctx->children[0]));
     auto* rhs = std::any_cast<ExpressionNode*>(visit(ctx->children[2]));
-    return (ExpressionNode*)new LessEqNode(lhs, rhs, compiler);
+    return (ExpressionNode*)make<LessEqNode>(lhs, rhs, compiler);
 }
 
 std::any
@@ -433,35 +455,35 @@ ASTBuilderVisitor::visitGreaterThanOrEqualExpression(kyoto::KyotoParser::Greater
 {
     auto* lhs = std::any_cast<ExpressionNode*>(visit(ctx->children[0]));
     auto* rhs = std::any_cast<ExpressionNode*>(visit(ctx->children[2]));
-    return (ExpressionNode*)new GreaterEqNode(lhs, rhs, compiler);
+    return (ExpressionNode*)make<GreaterEqNode>(lhs, rhs, compiler);
 }
 
 std::any ASTBuilderVisitor::visitEqualsExpression(kyoto::KyotoParser::EqualsExpressionContext* ctx)
 {
     auto* lhs = std::any_cast<ExpressionNode*>(visit(ctx->children[0]));
     auto* rhs = std::any_cast<ExpressionNode*>(visit(ctx->children[2]));
-    return (ExpressionNode*)new EqNode(lhs, rhs, compiler);
+    return (ExpressionNode*)make<EqNode>(lhs, rhs, compiler);
 }
 
 std::any ASTBuilderVisitor::visitNotEqualsExpression(kyoto::KyotoParser::NotEqualsExpressionContext* ctx)
 {
     auto* lhs = std::any_cast<ExpressionNode*>(visit(ctx->children[0]));
     auto* rhs = std::any_cast<ExpressionNode*>(visit(ctx->children[2]));
-    return (ExpressionNode*)new NotEqNode(lhs, rhs, compiler);
+    return (ExpressionNode*)make<NotEqNode>(lhs, rhs, compiler);
 }
 
 std::any ASTBuilderVisitor::visitLogicalAndExpression(kyoto::KyotoParser::LogicalAndExpressionContext* ctx)
 {
     auto* lhs = std::any_cast<ExpressionNode*>(visit(ctx->children[0]));
     auto* rhs = std::any_cast<ExpressionNode*>(visit(ctx->children[2]));
-    return (ExpressionNode*)new LogicalAndNode(lhs, rhs, compiler);
+    return (ExpressionNode*)make<LogicalAndNode>(lhs, rhs, compiler);
 }
 
 std::any ASTBuilderVisitor::visitLogicalOrExpression(kyoto::KyotoParser::LogicalOrExpressionContext* ctx)
 {
     auto* lhs = std::any_cast<ExpressionNode*>(visit(ctx->children[0]));
     auto* rhs = std::any_cast<ExpressionNode*>(visit(ctx->children[2]));
-    return (ExpressionNode*)new LogicalOrNode(lhs, rhs, compiler);
+    return (ExpressionNode*)make<LogicalOrNode>(lhs, rhs, compiler);
 }
 
 std::any ASTBuilderVisitor::visitParenthesizedExpression(kyoto::KyotoParser::ParenthesizedExpressionContext* ctx)
@@ -481,7 +503,7 @@ std::any ASTBuilderVisitor::visitMatchExpression(kyoto::KyotoParser::MatchExpres
                               std::any_cast<ExpressionNode*>(visit(case_ctx->expression(1))) });
         }
     }
-    return (ExpressionNode*)new MatchNode(expr, cases, compiler);
+    return (ExpressionNode*)make<MatchNode>(expr, cases, compiler);
 }
 
 std::any ASTBuilderVisitor::visitArrayExpression(kyoto::KyotoParser::ArrayExpressionContext* ctx)
@@ -489,7 +511,7 @@ std::any ASTBuilderVisitor::visitArrayExpression(kyoto::KyotoParser::ArrayExpres
     auto* type = std::any_cast<KType*>(visit(ctx->type()));
 
     if (!type->is_array()) {
-        type = new ArrayType(type, ctx->expressionList()->expression().size());
+        type = make<ArrayType>(type, ctx->expressionList()->expression().size());
     } else {
         type->as<ArrayType>()->set_size(ctx->expressionList()->expression().size());
     }
@@ -499,28 +521,28 @@ std::any ASTBuilderVisitor::visitArrayExpression(kyoto::KyotoParser::ArrayExpres
     for (const auto arg : ctx->expressionList()->expression()) {
         elems.push_back(std::any_cast<ExpressionNode*>(visit(arg)));
     }
-    return (ExpressionNode*)new ArrayNode(elems, type, compiler);
+    return (ExpressionNode*)make<ArrayNode>(elems, type, compiler);
 }
 
 std::any ASTBuilderVisitor::visitSliceExpression(kyoto::KyotoParser::SliceExpressionContext* ctx)
 {
     auto* ptr = std::any_cast<ExpressionNode*>(visit(ctx->expression(0)));
     auto* size = std::any_cast<ExpressionNode*>(visit(ctx->expression(1)));
-    return (ExpressionNode*)new SliceNode(ptr, size, compiler);
+    return (ExpressionNode*)make<SliceNode>(ptr, size, compiler);
 }
 
 std::any ASTBuilderVisitor::visitArrayIndexExpression(kyoto::KyotoParser::ArrayIndexExpressionContext* ctx)
 {
     auto* array = std::any_cast<ExpressionNode*>(visit(ctx->expression(0)));
     auto* index = std::any_cast<ExpressionNode*>(visit(ctx->expression(1)));
-    return (ExpressionNode*)new ArrayIndexNode(array, index, compiler);
+    return (ExpressionNode*)make<ArrayIndexNode>(array, index, compiler);
 }
 
 std::any ASTBuilderVisitor::visitCastExpression(kyoto::KyotoParser::CastExpressionContext* ctx)
 {
     auto* type = std::any_cast<KType*>(visit(ctx->type()));
     auto* expr = std::any_cast<ExpressionNode*>(visit(ctx->expression()));
-    return (ExpressionNode*)new CastNode(type, expr, compiler);
+    return (ExpressionNode*)make<CastNode>(type, expr, compiler);
 }
 
 std::any ASTBuilderVisitor::visitNewExpression(kyoto::KyotoParser::NewExpressionContext* ctx)
@@ -532,7 +554,7 @@ std::any ASTBuilderVisitor::visitNewExpression(kyoto::KyotoParser::NewExpression
     for (const auto arg : ctx->expressionList()->expression()) {
         args.push_back(std::any_cast<ExpressionNode*>(visit(arg)));
     }
-    return (ExpressionNode*)new NewNode(type, new FunctionCall(type->get_class_name(), args, compiler), compiler);
+    return (ExpressionNode*)make<NewNode>(type, make<FunctionCall>(type->get_class_name(), args, compiler), compiler);
 }
 
 std::any ASTBuilderVisitor::visitNewArrayExpression(kyoto::KyotoParser::NewArrayExpressionContext* ctx)
@@ -543,18 +565,29 @@ std::any ASTBuilderVisitor::visitNewArrayExpression(kyoto::KyotoParser::NewArray
             std::format("Only primitive, class, and pointer types are supported for new array expressions. Found: {}",
                         type->to_string()));
 
+    uint64_t align = 0;
+    if (ctx->ALIGN()) {
+        align = std::stoull(ctx->INTEGER()->getText());
+        if (!std::has_single_bit(align) || align > NewArrayNode::max_align)
+            throw std::runtime_error(std::format("Array alignment must be a power of two no larger than {}, got {}",
+                                                 NewArrayNode::max_align, align));
+    }
+
     auto* size_expr = std::any_cast<ExpressionNode*>(visit(ctx->expression()));
-    return (ExpressionNode*)new NewArrayNode(type, size_expr, compiler);
+    return (ExpressionNode*)make<NewArrayNode>(type, size_expr, compiler, align, ctx->ZEROED() != nullptr);
 }
 
 std::any ASTBuilderVisitor::visitSizeofExpression(kyoto::KyotoParser::SizeofExpressionContext* ctx)
 {
     if (ctx->type()) {
         auto* type = std::any_cast<KType*>(visit(ctx->type()));
-        return (ExpressionNode*)new SizeofNode(type, compiler);
+        return (ExpressionNode*)make<SizeofNode>(type, compiler);
+    } else if (is_template_param(ctx->expression()->getText())) {
+        // `sizeof(T)` parses as an identifier expression.
+        return (ExpressionNode*)make<SizeofNode>(instance->argument->copy(), compiler);
     } else {
         auto* expr = std::any_cast<ExpressionNode*>(visit(ctx->expression()));
-        return (ExpressionNode*)new SizeofNode(expr, compiler);
+        return (ExpressionNode*)make<SizeofNode>(expr, compiler);
     }
 }
 
@@ -584,7 +617,7 @@ std::any ASTBuilderVisitor::visitIfStatement(kyoto::KyotoParser::IfStatementCont
         }
     }
 
-    return (ASTNode*)new IfStatementNode(conditions, bodies, compiler);
+    return (ASTNode*)make<IfStatementNode>(conditions, bodies, compiler);
 }
 
 std::any ASTBuilderVisitor::visitForInit(kyoto::KyotoParser::ForInitContext* ctx)
@@ -619,7 +652,7 @@ std::any ASTBuilderVisitor::visitForStatement(kyoto::KyotoParser::ForStatementCo
     auto* update = update_any.has_value() ? std::any_cast<ExpressionNode*>(update_any) : nullptr;
 
     auto* body = std::any_cast<ASTNode*>(visit(ctx->block()));
-    return (ASTNode*)new ForStatementNode(init, condition, update, body, compiler);
+    return (ASTNode*)make<ForStatementNode>(init, condition, update, body, compiler);
 }
 
 std::any ASTBuilderVisitor::visitWhileStatement(kyoto::KyotoParser::WhileStatementContext* ctx)
@@ -627,26 +660,22 @@ std::any ASTBuilderVisitor::visitWhileStatement(kyoto::KyotoParser::WhileStateme
     auto* condition = std::any_cast<ExpressionNode*>(visit(ctx->expression()));
     auto* body = std::any_cast<ASTNode*>(visit(ctx->block()));
     // NOTE: We represent while loops as for loops with only a condition.
-    return (ASTNode*)new ForStatementNode(nullptr, new ExpressionStatementNode(condition, compiler), nullptr, body,
-                                          compiler);
+    return (ASTNode*)make<ForStatementNode>(nullptr, make<ExpressionStatementNode>(condition, compiler), nullptr, body,
+                                            compiler);
 }
 
 std::any ASTBuilderVisitor::visitClassDefinition(kyoto::KyotoParser::ClassDefinitionContext* ctx)
 {
     const auto raw_class_name = ctx->IDENTIFIER(0)->getText();
-    const auto class_name
+    auto class_name
         = raw_class_name.find("__") != std::string::npos ? raw_class_name : compiler.qualify_local_name(raw_class_name);
     if (ctx->LESS_THAN()) {
-        std::string param = ctx->IDENTIFIER(1)->getText();
-
-        antlr4::Token* startToken = ctx->getStart();
-        antlr4::Token* stopToken = ctx->getStop();
-        size_t start = startToken->getStartIndex();
-        size_t stop = stopToken->getStopIndex();
-        std::string raw_text = compiler.get_code().substr(start, stop - start + 1);
-
-        compiler.register_template(class_name, param, raw_text);
-        return std::any();
+        // Generic classes are only built through instantiate_template, which hands back this same subtree.
+        if (instance == nullptr) {
+            compiler.register_template(class_name, ctx->IDENTIFIER(1)->getText(), ctx);
+            return std::any();
+        }
+        class_name = instance->name;
     }
 
     std::vector<ASTNode*> components;
@@ -659,7 +688,7 @@ std::any ASTBuilderVisitor::visitClassDefinition(kyoto::KyotoParser::ClassDefini
     if (ctx->COLON()) {
         parent = compiler.qualify_local_name(ctx->IDENTIFIER().back()->getText());
     }
-    return (ASTNode*)new ClassDefinitionNode(class_name, parent, components, compiler);
+    return (ASTNode*)make<ClassDefinitionNode>(class_name, parent, components, compiler);
 }
 
 std::any ASTBuilderVisitor::visitClassComponent(kyoto::KyotoParser::ClassComponentContext* ctx)
@@ -680,47 +709,68 @@ std::any ASTBuilderVisitor::visitConstructorDefinition(kyoto::KyotoParser::Const
 
     auto* body = std::any_cast<ASTNode*>(visit(ctx->block()));
     auto name = compiler.get_current_class() + "_" + "constructor";
-    return (ASTNode*)new ConstructorNode(name, args, body, compiler);
+    return (ASTNode*)make<ConstructorNode>(name, args, body, compiler);
 }
 
 std::any ASTBuilderVisitor::visitBoolType(kyoto::KyotoParser::BoolTypeContext* ctx)
 {
-    return (KType*)new PrimitiveType(PrimitiveType::Kind::Boolean);
+    return (KType*)make<PrimitiveType>(PrimitiveType::Kind::Boolean);
 }
 
 std::any ASTBuilderVisitor::visitCharType(kyoto::KyotoParser::CharTypeContext* ctx)
 {
-    return (KType*)new PrimitiveType(PrimitiveType::Kind::Char);
+    return (KType*)make<PrimitiveType>(PrimitiveType::Kind::Char);
 }
 
 std::any ASTBuilderVisitor::visitI8Type(kyoto::KyotoParser::I8TypeContext* ctx)
 {
-    return (KType*)new PrimitiveType(PrimitiveType::Kind::I8);
+    return (KType*)make<PrimitiveType>(PrimitiveType::Kind::I8);
 }
 
 std::any ASTBuilderVisitor::visitI16Type(kyoto::KyotoParser::I16TypeContext* ctx)
 {
-    return (KType*)new PrimitiveType(PrimitiveType::Kind::I16);
+    return (KType*)make<PrimitiveType>(PrimitiveType::Kind::I16);
 }
 
 std::any ASTBuilderVisitor::visitI32Type(kyoto::KyotoParser::I32TypeContext* ctx)
 {
-    return (KType*)new PrimitiveType(PrimitiveType::Kind::I32);
+    return (KType*)make<PrimitiveType>(PrimitiveType::Kind::I32);
 }
 
 std::any ASTBuilderVisitor::visitI64Type(kyoto::KyotoParser::I64TypeContext* ctx)
 {
-    return (KType*)new PrimitiveType(PrimitiveType::Kind::I64);
+    return (KType*)make<PrimitiveType>(PrimitiveType::Kind::I64);
 }
 
 std::any ASTBuilderVisitor::visitF32Type(kyoto::KyotoParser::F32TypeContext* ctx)
 {
-    return (KType*)new PrimitiveType(PrimitiveType::Kind::F32);
+    return (KType*)make<PrimitiveType>(PrimitiveType::Kind::F32);
 }
 
 std::any ASTBuilderVisitor::visitF64Type(kyoto::KyotoParser::F64TypeContext* ctx)
 {
-    return (KType*)new PrimitiveType(PrimitiveType::Kind::F64);
+    return (KType*)make<PrimitiveType>(PrimitiveType::Kind::F64);
+}
+
+std::any ASTBuilderVisitor::visitVectorType(kyoto::KyotoParser::VectorTypeContext* ctx)
+{
+    static const std::unordered_map<std::string, PrimitiveType::Kind> element_kinds = {
+        { "bool", PrimitiveType::Kind::Boolean },
+        { "i8", PrimitiveType::Kind::I8 },
+        { "i16", PrimitiveType::Kind::I16 },
+        { "i32", PrimitiveType::Kind::I32 },
+        { "i64", PrimitiveType::Kind::I64 },
+        { "f32", PrimitiveType::Kind::F32 },
+        { "f64", PrimitiveType::Kind::F64 },
+    };
+
+    const auto text = ctx->VECTOR_TYPE()->getText();
+    const auto separator = text.find('x');
+    const auto element_name = text.substr(0, separator);
+    // The lexer only produces supported lane counts.
+    const auto lanes = std::stoull(text.substr(separator + 1));
+
+    return (KType*)make<VectorType>(make<PrimitiveType>(element_kinds.at(element_name)), lanes);
 }
 
 std::any ASTBuilderVisitor::visitVoidType(kyoto::KyotoParser::VoidTypeContext* ctx)
@@ -730,19 +780,19 @@ std::any ASTBuilderVisitor::visitVoidType(kyoto::KyotoParser::VoidTypeContext* c
 
 std::any ASTBuilderVisitor::visitStrType(kyoto::KyotoParser::StrTypeContext* ctx)
 {
-    return (KType*)new PointerType(new PrimitiveType(PrimitiveType::Kind::Char));
+    return (KType*)make<PointerType>(make<PrimitiveType>(PrimitiveType::Kind::Char));
 }
 
 std::any ASTBuilderVisitor::visitArrayType(kyoto::KyotoParser::ArrayTypeContext* ctx)
 {
     auto* type = std::any_cast<KType*>(visit(ctx->type()));
-    return (KType*)new ArrayType(type, 0);
+    return (KType*)make<ArrayType>(type, 0);
 }
 
 std::any ASTBuilderVisitor::visitSliceType(kyoto::KyotoParser::SliceTypeContext* ctx)
 {
     auto* type = std::any_cast<KType*>(visit(ctx->type()));
-    return (KType*)new SliceType(type);
+    return (KType*)make<SliceType>(type);
 }
 
 std::any ASTBuilderVisitor::visitFunctionType(kyoto::KyotoParser::FunctionTypeContext* ctx)
@@ -753,14 +803,14 @@ std::any ASTBuilderVisitor::visitFunctionType(kyoto::KyotoParser::FunctionTypeCo
     }
 
     auto* return_type = std::any_cast<KType*>(visit(ctx->type()));
-    return (KType*)new FunctionType(std::move(param_types), return_type);
+    return (KType*)make<FunctionType>(std::move(param_types), return_type);
 }
 
 std::any ASTBuilderVisitor::visitPointerType(kyoto::KyotoParser::PointerTypeContext* ctx)
 {
     auto* type = std::any_cast<KType*>(visit(ctx->type()));
     for (size_t i = 0; i < ctx->ASTERISK().size(); ++i)
-        type = new PointerType(type);
+        type = make<PointerType>(type);
     return type;
 }
 
@@ -770,18 +820,12 @@ std::any ASTBuilderVisitor::visitClassType(kyoto::KyotoParser::ClassTypeContext*
 
     if (ctx->LESS_THAN()) {
         KType* inner = std::any_cast<KType*>(visit(ctx->type()));
-        std::string inner_text = stringify_type_for_template(inner);
-
-        std::string inner_mangled = inner_text;
-        std::replace(inner_mangled.begin(), inner_mangled.end(), '*', '_');
-        std::replace(inner_mangled.begin(), inner_mangled.end(), '<', '_');
-        std::replace(inner_mangled.begin(), inner_mangled.end(), '>', '_');
-        std::replace(inner_mangled.begin(), inner_mangled.end(), '[', '_');
-        std::replace(inner_mangled.begin(), inner_mangled.end(), ']', '_');
-
-        std::string mangled_name = compiler.qualify_local_name(type_name + "_" + inner_mangled);
-        compiler.instantiate_template(compiler.qualify_local_name(type_name), mangled_name, inner_text);
+        std::string mangled_name = compiler.qualify_local_name(type_name + "_" + mangle_template_argument(inner));
+        compiler.instantiate_template(compiler.qualify_local_name(type_name), mangled_name, inner);
+        delete inner;
         type_name = mangled_name;
+    } else if (is_template_param(type_name)) {
+        return (KType*)instance->argument->copy();
     }
 
     KType* alias_type = compiler.resolve_type_alias(type_name);
@@ -789,10 +833,15 @@ std::any ASTBuilderVisitor::visitClassType(kyoto::KyotoParser::ClassTypeContext*
         return (KType*)alias_type->copy();
     }
 
+    if (is_unsupported_vector_type_name(type_name)) {
+        throw std::runtime_error(std::format("Vector type `{}` must have a power of two lanes between {} and {}",
+                                             type_name, VectorType::min_lanes, VectorType::max_lanes));
+    }
+
     if (type_name.find("__") != std::string::npos) {
-        return (KType*)new ClassType(type_name);
+        return (KType*)make<ClassType>(type_name);
     }
-    return (KType*)new ClassType(compiler.qualify_local_name(type_name));
+    return (KType*)make<ClassType>(compiler.qualify_local_name(type_name));
 }
 
 std::any ASTBuilderVisitor::visitQualifiedClassType(kyoto::KyotoParser::QualifiedClassTypeContext* ctx)
@@ -802,18 +851,11 @@ std::any ASTBuilderVisitor::visitQualifiedClassType(kyoto::KyotoParser::Qualifie
 
     if (ctx->LESS_THAN()) {
         KType* inner = std::any_cast<KType*>(visit(ctx->type()));
-        std::string inner_text = stringify_type_for_template(inner);
-
-        std::string inner_mangled = inner_text;
-        std::replace(inner_mangled.begin(), inner_mangled.end(), '*', '_');
-        std::replace(inner_mangled.begin(), inner_mangled.end(), '<', '_');
-        std::replace(inner_mangled.begin(), inner_mangled.end(), '>', '_');
-        std::replace(inner_mangled.begin(), inner_mangled.end(), '[', '_');
-        std::replace(inner_mangled.begin(), inner_mangled.end(), ']', '_');
-
         const auto qualified_template_name = compiler.qualify_imported_name(module_name, alias);
-        const auto mangled_name = compiler.qualify_imported_name(module_name, alias + "_" + inner_mangled);
-        compiler.instantiate_template(qualified_template_name, mangled_name, inner_text);
+        const auto mangled_name
+            = compiler.qualify_imported_name(module_name, alias + "_" + mangle_template_argument(inner));
+        compiler.instantiate_template(qualified_template_name, mangled_name, inner);
+        delete inner;
         alias = mangled_name;
     }
 
@@ -822,10 +864,10 @@ std::any ASTBuilderVisitor::visitQualifiedClassType(kyoto::KyotoParser::Qualifie
     }
 
     if (alias.find("__") != std::string::npos) {
-        return (KType*)new ClassType(alias);
+        return (KType*)make<ClassType>(alias);
     }
 
-    return (KType*)new ClassType(compiler.qualify_imported_name(module_name, alias));
+    return (KType*)make<ClassType>(compiler.qualify_imported_name(module_name, alias));
 }
 
 std::string ASTBuilderVisitor::visit_module_path(kyoto::KyotoParser::ModulePathContext* ctx) const
@@ -838,6 +880,22 @@ std::string ASTBuilderVisitor::visit_module_path(kyoto::KyotoParser::ModulePathC
     return module_name;
 }
 
+std::string ASTBuilderVisitor::mangle_template_argument(const KType* type) const
+{
+    std::string mangled = stringify_type_for_template(type);
+    std::replace(mangled.begin(), mangled.end(), '*', '_');
+    std::replace(mangled.begin(), mangled.end(), '<', '_');
+    std::replace(mangled.begin(), mangled.end(), '>', '_');
+    std::replace(mangled.begin(), mangled.end(), '[', '_');
+    std::replace(mangled.begin(), mangled.end(), ']', '_');
+    return mangled;
+}
+
+bool ASTBuilderVisitor::is_template_param(const std::string& name) const
+{
+    return instance != nullptr && name == instance->param;
+}
+
 std::string ASTBuilderVisitor::stringify_type_for_template(const KType* type) const
 {
     if (type->is_pointer()) {
@@ -852,6 +910,12 @@ std::string ASTBuilderVisitor::stringify_type_for_template(const KType* type) co
         return "[" + stringify_type_for_template(type->as<SliceType>()->get_element_type()) + "]";
     }
 
+    if (type->is_vector()) {
+        const auto* vector_type = type->as<VectorType>();
+        return stringify_type_for_template(vector_type->get_element_type()) + "x"
+            + std::to_string(vector_type->get_lanes());
+    }
+
     if (type->is_function()) {
         const auto* function_type = type->as<FunctionType>();
         std::string result = "fn(";
@@ -871,7 +935,7 @@ std::string ASTBuilderVisitor::stringify_type_for_template(const KType* type) co
     if (type->is_void()) return "void";
     if (type->is_string()) return "str";
 
-    if (const auto* primitive = dynamic_cast<const PrimitiveType*>(type)) {
+    if (const auto* primitive = llvm::dyn_cast<PrimitiveType>(type)) {
         switch (primitive->get_kind()) {
         case PrimitiveType::Kind::Boolean:
             return "bool";
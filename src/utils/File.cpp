@@ -6,6 +6,7 @@
 #include <boost/filesystem/path.hpp>
 #include <boost/fusion/algorithm/iteration/for_each.hpp>
 #include <boost/fusion/sequence/intrinsic/at_key.hpp>
+#include <boost/process/args.hpp>
 #include <boost/process/child.hpp>
 #include <boost/process/detail/child_decl.hpp>
 #include <boost/process/io.hpp>
@@ -91,48 +92,31 @@ int32_t File::execute_ir(const std::string& ir)
     return ((exit_code & 0xFF) << 24) >> 24;
 }
 
-bool File::compile_ir_to_binary(const std::string& ir, const std::string& output_path)
+bool File::link_executable(const std::vector<std::filesystem::path>& objects, const std::string& output_path)
 {
-    auto temp_ir_file = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("temp-%%%%-%%%%.ll");
-    std::ofstream ofs(temp_ir_file.string());
-    if (!ofs.is_open()) {
-        std::cerr << "Error: Failed to create temporary IR file" << std::endl;
+    const auto linker = find_executable({ "cc", "gcc", "clang-20", "clang" });
+    if (!linker.has_value()) {
+        std::cerr << "Error: No suitable linker driver found (`cc`, `gcc` or `clang` required)" << std::endl;
         return false;
     }
-    ofs << ir;
-    ofs.close();
 
-    if (const auto clang = find_executable({ "clang-20", "clang" }); clang.has_value()) {
-        boost::process::child proc { *clang, "-O2", temp_ir_file.string(), "-o", output_path };
-        proc.wait();
-        boost::filesystem::remove(temp_ir_file);
-        return proc.exit_code() == 0;
+    std::vector<std::string> args;
+    args.reserve(objects.size() + 2);
+    for (const auto& object : objects) {
+        args.push_back(object.string());
     }
+    args.push_back("-o");
+    args.push_back(output_path);
 
-    const auto llc = find_executable({ "llc-20", "llc" });
-    const auto gcc = find_executable({ "gcc" });
-    if (llc.has_value() && gcc.has_value()) {
-        auto temp_asm_file
-            = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("temp-%%%%-%%%%.s");
-        boost::process::child llc_proc { *llc, "-O2", temp_ir_file.string(), "-o", temp_asm_file.string() };
-        llc_proc.wait();
-
-        if (llc_proc.exit_code() != 0) {
-            boost::filesystem::remove(temp_ir_file);
-            return false;
-        }
-
-        boost::process::child gcc_proc { *gcc, temp_asm_file.string(), "-o", output_path };
-        gcc_proc.wait();
-
-        boost::filesystem::remove(temp_ir_file);
-        boost::filesystem::remove(temp_asm_file);
-        return gcc_proc.exit_code() == 0;
-    }
+    boost::process::child proc { *linker, boost::process::args(args) };
+    proc.wait();
+    return proc.exit_code() == 0;
+}
 
-    boost::filesystem::remove(temp_ir_file);
-    std::cerr << "Error: No suitable compiler found (`clang` or `llc`+`gcc` required)" << std::endl;
-    return false;
+std::filesystem::path File::temp_path(const std::string& extension)
+{
+    const auto path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("temp-%%%%-%%%%");
+    return std::filesystem::path(path.string() + extension);
 }
 
 bool File::is_executable(const std::string& name)
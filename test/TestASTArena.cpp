@@ -0,0 +1,26 @@
+#include <gtest/gtest.h>
+
+#include "kyoto/AST/Expressions/BinaryNode.h"
+#include "kyoto/AST/Expressions/NumberNode.h"
+#include "kyoto/ASTArena.h"
+#include "kyoto/KType.h"
+#include "kyoto/ModuleCompiler.h"
+
+TEST(ASTArena, DeleteLeavesArenaObjectsAlive)
+{
+    ModuleCompiler compiler("", "arena_test");
+    ASTArena arena;
+
+    auto* i32 = arena.make<PrimitiveType>(PrimitiveType::Kind::I32);
+    auto* lhs = arena.make<NumberNode>(int64_t { 1 }, i32, compiler);
+    auto* rhs = arena.make<NumberNode>(int64_t { 2 }, i32->copy(), compiler);
+    auto* sum = arena.make<AddNode>(lhs, rhs, compiler);
+
+    ASTNode* node = sum;
+    delete node;
+    delete i32;
+
+    EXPECT_TRUE(sum->is<AddNode>());
+    EXPECT_EQ(lhs->to_string(), "I32(1)");
+    EXPECT_GE(arena.get_bytes_allocated(), sizeof(AddNode) + 2 * sizeof(NumberNode));
+}
@@ -0,0 +1,9 @@
+#include <gtest/gtest-param-test.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "kyoto/utils/File.h"
+#include "kyoto/utils/Test.h"
+
+DEFINE_KYOTO_TEST_SUITE(TestArena, "../test/code/arena.kyo");
\ No newline at end of file
@@ -6,13 +6,14 @@
 #include <stdint.h>
 #include <string>
 
+#include "kyoto/CompilerOptions.h"
 #include "kyoto/ModuleCompiler.h"
 #include "kyoto/utils/File.h"
 #include "kyoto/utils/Test.h"
 
 namespace utils {
 
-void test_driver(const utils::TestCase& test_case)
+void test_driver(const utils::TestCase& test_case, const CompilerOptions& options)
 {
     if (test_case.skip()) {
         GTEST_SKIP();
@@ -33,7 +34,7 @@ void test_driver(const utils::TestCase& test_case)
         out << test_case.code();
     }
 
-    ModuleCompiler compiler(test_case.code(), "main", temp_entry_path);
+    ModuleCompiler compiler(test_case.code(), "main", temp_entry_path, options);
     auto ir = compiler.gen_ir();
 
     if (temp_entry_path.has_value()) {
@@ -53,4 +54,20 @@ void test_driver(const utils::TestCase& test_case)
     }
 }
 
+std::string compile_ir(const std::string& code, const CompilerOptions& options)
+{
+    ModuleCompiler compiler(code, "main", std::nullopt, options);
+    auto ir = compiler.gen_ir();
+    EXPECT_TRUE(ir.has_value());
+    return ir.value_or("");
+}
+
+std::string compile_error(const std::string& code, const CompilerOptions& options)
+{
+    testing::internal::CaptureStderr();
+    ModuleCompiler compiler(code, "main", std::nullopt, options);
+    EXPECT_FALSE(compiler.gen_ir().has_value());
+    return testing::internal::GetCapturedStderr();
+}
+
 }
@@ -0,0 +1,67 @@
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <string>
+#include <sys/wait.h>
+
+#include "kyoto/ModuleCompiler.h"
+#include "kyoto/utils/File.h"
+
+namespace {
+
+constexpr auto* program = R"(
+fn triple(n: i32) i32 {
+    return n * 3;
+}
+
+fn main() i32 {
+    return triple(14);
+}
+)";
+
+std::string read_bytes(const std::filesystem::path& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    return { std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+}
+
+}
+
+TEST(Emit, ObjectLinksIntoRunnableExecutable)
+{
+    const auto object = utils::File::temp_path(".o");
+    const auto executable = utils::File::temp_path("");
+
+    ModuleCompiler compiler(program);
+    ASSERT_TRUE(compiler.gen_module());
+    ASSERT_TRUE(compiler.emit(ModuleCompiler::EmitKind::Object, object));
+
+    const auto bytes = read_bytes(object);
+    const bool linked = utils::File::link_executable({ object }, executable.string());
+    const int status = linked ? std::system(executable.string().c_str()) : -1;
+    std::filesystem::remove(object);
+    std::filesystem::remove(executable);
+
+    EXPECT_TRUE(bytes.starts_with("\x7f"
+                                  "ELF"));
+    ASSERT_TRUE(linked);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 42);
+}
+
+TEST(Emit, AssemblyDefinesEveryFunction)
+{
+    const auto assembly = utils::File::temp_path(".s");
+
+    ModuleCompiler compiler(program);
+    ASSERT_TRUE(compiler.gen_module());
+    ASSERT_TRUE(compiler.emit(ModuleCompiler::EmitKind::Assembly, assembly));
+
+    const auto text = read_bytes(assembly);
+    std::filesystem::remove(assembly);
+
+    EXPECT_NE(text.find("main:"), std::string::npos);
+    EXPECT_NE(text.find("triple"), std::string::npos);
+}
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+#include <string>
+
+#include "kyoto/utils/Test.h"
+
+namespace {
+
+constexpr auto* counter_class = R"(
+class Counter {
+    var n: i32;
+
+    constructor(self: Counter*, n: i32) {
+        self.n = n;
+    }
+
+    fn add(self: Counter*, x: i32) {
+        self.n = self.n + x;
+    }
+}
+)";
+
+}
+
+TEST(HeapToStack, NonEscapingNewIsStackAllocated)
+{
+    const auto ir = utils::compile_ir(counter_class + std::string(R"(
+fn main() i32 {
+    var c: Counter* = new Counter(5);
+    c.add(3);
+    var result: i32 = c.n;
+    free c;
+    return result;
+}
+)"));
+
+    EXPECT_NE(ir.find("%Counter = alloca ["), std::string::npos);
+    EXPECT_EQ(ir.find("call ptr @malloc"), std::string::npos);
+    EXPECT_EQ(ir.find("call void @free"), std::string::npos);
+}
+
+TEST(HeapToStack, ReturnedNewStaysOnTheHeap)
+{
+    const auto ir = utils::compile_ir(counter_class + std::string(R"(
+fn make(n: i32) Counter* {
+    var c: Counter* = new Counter(n);
+    return c;
+}
+
+fn main() i32 {
+    var c: Counter* = make(7);
+    var result: i32 = c.n;
+    free c;
+    return result;
+}
+)"));
+
+    EXPECT_NE(ir.find("call ptr @malloc"), std::string::npos);
+    EXPECT_NE(ir.find("call void @free"), std::string::npos);
+    EXPECT_EQ(ir.find("%Counter = alloca ["), std::string::npos);
+}
@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include <optional>
+#include <stdint.h>
+
+#include "kyoto/ModuleCompiler.h"
+
+namespace {
+
+// `abs`, `malloc` and `free` all have to be found in the test process itself.
+constexpr auto* host_symbols_program = R"(
+cdecl fn abs(n: i32) i32;
+
+class Cell {
+    var value: i32;
+
+    constructor(self: Cell*, value: i32) {
+        self.value = value;
+    }
+}
+
+fn keep(cell: Cell*) Cell* {
+    return cell;
+}
+
+fn main() i32 {
+    var cell: Cell* = keep(new Cell(abs(-40)));
+    var result: i32 = cell.value + 2;
+    free cell;
+    return result;
+}
+)";
+
+}
+
+TEST(Jit, RunsMainInProcess)
+{
+    ModuleCompiler compiler(host_symbols_program);
+    ASSERT_TRUE(compiler.gen_module());
+
+    const auto ret = compiler.run_jit();
+
+    ASSERT_TRUE(ret.has_value());
+    EXPECT_EQ(*ret, 42);
+}
+
+TEST(Jit, ModuleCanOnlyBeRunOnce)
+{
+    ModuleCompiler compiler(host_symbols_program);
+    ASSERT_TRUE(compiler.gen_module());
+    ASSERT_TRUE(compiler.run_jit().has_value());
+
+    EXPECT_FALSE(compiler.run_jit().has_value());
+}
@@ -0,0 +1,123 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <optional>
+#include <string>
+
+#include "kyoto/CompilerOptions.h"
+#include "kyoto/ModuleCache.h"
+#include "kyoto/ModuleCompiler.h"
+#include "kyoto/utils/File.h"
+
+namespace {
+
+std::optional<std::string> compile_with_cache(const std::string& code, const std::filesystem::path& entry_path,
+                                              const std::filesystem::path& cache_dir)
+{
+    CompilerOptions options;
+    options.cache_dir = cache_dir;
+    ModuleCompiler compiler(code, "main", entry_path, options);
+    return compiler.gen_ir();
+}
+
+void write_file(const std::filesystem::path& path, const std::string& contents)
+{
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream out(path);
+    out << contents;
+}
+
+size_t count_entries(const std::filesystem::path& cache_dir)
+{
+    if (!std::filesystem::exists(cache_dir)) return 0;
+    return std::distance(std::filesystem::directory_iterator(cache_dir), std::filesystem::directory_iterator {});
+}
+
+}
+
+TEST(TestModuleCache, ImportedModuleIsReusedAcrossCompilations)
+{
+    const auto unique = std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    const auto cache_dir = std::filesystem::temp_directory_path() / ("kyoto-cache-" + unique);
+    const auto entry_path = std::filesystem::path("../test/code") / (".tmp-cache-" + unique + ".kyo");
+    const std::string code = "import mods.a;\n\nfn main() i32 {\n    return mods.a::answer() + 1;\n}\n";
+    {
+        std::ofstream out(entry_path);
+        ASSERT_TRUE(out.is_open());
+        out << code;
+    }
+
+    auto cold = compile_with_cache(code, entry_path, cache_dir);
+    const auto entries_after_cold = count_entries(cache_dir);
+    auto warm = compile_with_cache(code, entry_path, cache_dir);
+    const auto entries_after_warm = count_entries(cache_dir);
+
+    std::filesystem::remove(entry_path);
+    std::filesystem::remove_all(cache_dir);
+
+    ASSERT_TRUE(cold.has_value());
+    ASSERT_TRUE(warm.has_value());
+    EXPECT_EQ(entries_after_cold, 1u);
+    EXPECT_EQ(entries_after_warm, 1u);
+    EXPECT_EQ(utils::File::execute_ir(*cold), 43);
+    EXPECT_EQ(utils::File::execute_ir(*warm), 43);
+}
+
+TEST(TestModuleCache, CompilerIsIdentifiedByItsBinary)
+{
+    const auto version = ModuleCache::compiler_version();
+
+    EXPECT_EQ(version, ModuleCache::compiler_version());
+    EXPECT_EQ(version.find("unidentified"), std::string::npos);
+}
+
+TEST(TestModuleCache, TemplateInstancesSharedByTwoImporters)
+{
+    const auto unique = std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    const auto root = std::filesystem::temp_directory_path() / ("kyoto-generic-" + unique);
+    const auto cache_dir = root / "cache";
+    const auto entry_path = root / "main.kyo";
+    const std::string code = "import gen.left;\nimport gen.right;\n\n"
+                             "fn main() i32 {\n    return gen.left::left() + gen.right::right();\n}\n";
+    const std::string left_plain = "fn left() i32 {\n    return 1;\n}\n";
+    const std::string left_boxed = "import box;\n\n"
+                                   "fn left() i32 {\n"
+                                   "    var b: box::Box<i32>* = new box::Box<i32>(1);\n"
+                                   "    return b.get();\n"
+                                   "}\n";
+    write_file(entry_path, code);
+    write_file(root / "gen" / "box.kyo", "class Box<T> {\n"
+                                         "    var value: T;\n\n"
+                                         "    constructor(self: Box<T>*, value: T) {\n"
+                                         "        self.value = value;\n"
+                                         "    }\n\n"
+                                         "    fn get(self: Box<T>*) T {\n"
+                                         "        return self.value;\n"
+                                         "    }\n"
+                                         "}\n");
+    write_file(root / "gen" / "right.kyo", "import box;\n\n"
+                                           "fn right() i32 {\n"
+                                           "    var b: box::Box<i32>* = new box::Box<i32>(2);\n"
+                                           "    return b.get();\n"
+                                           "}\n");
+
+    // `gen.left` is built before `gen.right`, so whether it uses the template decides which of the two instantiates
+    // it first, while the key of `gen.right` stays the same across all three compilations.
+    write_file(root / "gen" / "left.kyo", left_boxed);
+    auto left_instantiates = compile_with_cache(code, entry_path, cache_dir);
+    write_file(root / "gen" / "left.kyo", left_plain);
+    auto right_instantiates = compile_with_cache(code, entry_path, cache_dir);
+    write_file(root / "gen" / "left.kyo", left_boxed);
+    auto both_cached = compile_with_cache(code, entry_path, cache_dir);
+
+    std::filesystem::remove_all(root);
+
+    ASSERT_TRUE(left_instantiates.has_value());
+    ASSERT_TRUE(right_instantiates.has_value());
+    ASSERT_TRUE(both_cached.has_value());
+    EXPECT_EQ(utils::File::execute_ir(*left_instantiates), 3);
+    EXPECT_EQ(utils::File::execute_ir(*right_instantiates), 3);
+    EXPECT_EQ(utils::File::execute_ir(*both_cached), 3);
+}
@@ -0,0 +1,56 @@
+#include <gtest/gtest-param-test.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "kyoto/CompilerOptions.h"
+#include "kyoto/utils/File.h"
+#include "kyoto/utils/Test.h"
+
+// The loop and function suites are otherwise run unoptimized, so they are run again at every other level.
+DEFINE_KYOTO_TEST_SUITE_WITH_OPTIONS(TestForO1, "../test/code/for.kyo", CompilerOptions { .opt_level = OptLevel::O1 });
+DEFINE_KYOTO_TEST_SUITE_WITH_OPTIONS(TestForO2, "../test/code/for.kyo", CompilerOptions { .opt_level = OptLevel::O2 });
+DEFINE_KYOTO_TEST_SUITE_WITH_OPTIONS(TestForO3, "../test/code/for.kyo", CompilerOptions { .opt_level = OptLevel::O3 });
+DEFINE_KYOTO_TEST_SUITE_WITH_OPTIONS(TestForOs, "../test/code/for.kyo", CompilerOptions { .opt_level = OptLevel::Os });
+DEFINE_KYOTO_TEST_SUITE_WITH_OPTIONS(TestFunctionO1, "../test/code/func.kyo",
+                                     CompilerOptions { .opt_level = OptLevel::O1 });
+DEFINE_KYOTO_TEST_SUITE_WITH_OPTIONS(TestFunctionO2, "../test/code/func.kyo",
+                                     CompilerOptions { .opt_level = OptLevel::O2 });
+DEFINE_KYOTO_TEST_SUITE_WITH_OPTIONS(TestFunctionO3, "../test/code/func.kyo",
+                                     CompilerOptions { .opt_level = OptLevel::O3 });
+DEFINE_KYOTO_TEST_SUITE_WITH_OPTIONS(TestFunctionOs, "../test/code/func.kyo",
+                                     CompilerOptions { .opt_level = OptLevel::Os });
+
+namespace {
+
+constexpr auto* sum_of_squares = R"(
+fn sum_of_squares(n: i32) i32 {
+    var sum: i32 = 0;
+    for (var i = 0; i < n; ++i) {
+        sum = sum + i * i;
+    }
+    return sum;
+}
+
+fn main() i32 {
+    return sum_of_squares(4);
+}
+)";
+
+}
+
+TEST(OptLevels, O0KeepsLocalsInMemory)
+{
+    const auto ir = utils::compile_ir(sum_of_squares, CompilerOptions { .opt_level = OptLevel::O0 });
+
+    EXPECT_NE(ir.find("alloca"), std::string::npos);
+    EXPECT_EQ(utils::File::execute_ir(ir), 14);
+}
+
+TEST(OptLevels, O2PromotesLocalsToRegisters)
+{
+    const auto ir = utils::compile_ir(sum_of_squares, CompilerOptions { .opt_level = OptLevel::O2 });
+
+    EXPECT_EQ(ir.find("alloca"), std::string::npos);
+    EXPECT_EQ(utils::File::execute_ir(ir), 14);
+}
@@ -0,0 +1,36 @@
+#include <gtest/gtest-param-test.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "kyoto/CompilerOptions.h"
+#include "kyoto/utils/File.h"
+#include "kyoto/utils/Test.h"
+
+DEFINE_KYOTO_TEST_SUITE_WITH_OPTIONS(TestPoolAllocator, "../test/code/pool.kyo",
+                                     CompilerOptions { .alloc = AllocMode::Pool });
+
+namespace {
+
+std::string pooled_source()
+{
+    return utils::File::get_test_cases("../test/code/pool.kyo").front().code();
+}
+
+}
+
+TEST(PoolAllocator, NewAndFreeGoThroughThePool)
+{
+    const auto ir = utils::compile_ir(pooled_source(), CompilerOptions { .alloc = AllocMode::Pool });
+
+    EXPECT_NE(ir.find("@__kyoto_pool_alloc"), std::string::npos);
+    EXPECT_NE(ir.find("@__kyoto_pool_free"), std::string::npos);
+}
+
+TEST(PoolAllocator, MallocIsTheDefault)
+{
+    const auto ir = utils::compile_ir(pooled_source());
+
+    EXPECT_EQ(ir.find("@__kyoto_pool_alloc"), std::string::npos);
+    EXPECT_NE(ir.find("call ptr @malloc"), std::string::npos);
+}
@@ -3,7 +3,105 @@
 #include <string>
 #include <vector>
 
+#include "kyoto/CompilerOptions.h"
 #include "kyoto/utils/File.h"
 #include "kyoto/utils/Test.h"
 
 DEFINE_KYOTO_TEST_SUITE(TestSlices, "../test/code/slices.kyo");
+DEFINE_KYOTO_TEST_SUITE_WITH_OPTIONS(TestSlicesTrapOnly, "../test/code/slices.kyo",
+                                     CompilerOptions { .bounds_checks = BoundsCheckMode::TrapOnly });
+
+namespace {
+
+bool has_check(const std::string& ir)
+{
+    return ir.find("slice_oob") != std::string::npos;
+}
+
+constexpr auto* induction_loop = R"(
+fn main() i32 {
+    var arr: i32[] = i32{1, 2, 3, 4};
+    var s: [i32] = [&arr[0], 4];
+    var sum: i32 = 0;
+    for (var i: i64 = 0; i < s.size; ++i) {
+        sum = sum + s[i];
+    }
+    return sum;
+}
+)";
+
+constexpr auto* unproven_index = R"(
+fn main() i32 {
+    var arr: i32[] = i32{1, 2, 3, 4};
+    var s: [i32] = [&arr[0], 4];
+    var k: i64 = 3;
+    return s[k];
+}
+)";
+
+}
+
+TEST(SliceBoundsChecks, ProvenInductionLoopHasNoCheck)
+{
+    const auto ir = utils::compile_ir(induction_loop);
+
+    EXPECT_FALSE(has_check(ir));
+    EXPECT_EQ(utils::File::execute_ir(ir), 10);
+}
+
+TEST(SliceBoundsChecks, UnprovenIndexIsChecked)
+{
+    const auto ir = utils::compile_ir(unproven_index);
+
+    EXPECT_TRUE(has_check(ir));
+    EXPECT_NE(ir.find("@__kyoto_slice_oob"), std::string::npos);
+    EXPECT_EQ(utils::File::execute_ir(ir), 4);
+}
+
+TEST(SliceBoundsChecks, AddressTakenAnywhereKeepsTheCheck)
+{
+    const auto ir = utils::compile_ir(R"(
+fn main() i32 {
+    var arr: i32[] = i32{1, 2, 3, 4};
+    var s: [i32] = [&arr[0], 4];
+    var sum: i32 = 0;
+    for (var round = 0; round < 2; ++round) {
+        for (var i: i64 = 0; i < s.size; ++i) {
+            sum = sum + s[i];
+        }
+        var p: [i32]* = &s;
+    }
+    return sum;
+}
+)");
+
+    EXPECT_TRUE(has_check(ir));
+    EXPECT_EQ(utils::File::execute_ir(ir), 20);
+}
+
+TEST(SliceBoundsChecks, OffRemovesEveryCheck)
+{
+    const auto ir = utils::compile_ir(unproven_index, CompilerOptions { .bounds_checks = BoundsCheckMode::Off });
+
+    EXPECT_FALSE(has_check(ir));
+    EXPECT_EQ(ir.find("@llvm.trap"), std::string::npos);
+    EXPECT_EQ(utils::File::execute_ir(ir), 4);
+}
+
+TEST(SliceBoundsChecks, TrapOnlyTrapsWithoutAMessage)
+{
+    const auto ir = utils::compile_ir(unproven_index, CompilerOptions { .bounds_checks = BoundsCheckMode::TrapOnly });
+
+    EXPECT_TRUE(has_check(ir));
+    EXPECT_NE(ir.find("@llvm.trap"), std::string::npos);
+    EXPECT_EQ(ir.find("@__kyoto_slice_oob"), std::string::npos);
+    EXPECT_EQ(ir.find("index out of bounds"), std::string::npos);
+    EXPECT_EQ(utils::File::execute_ir(ir), 4);
+}
+
+TEST(SliceBoundsChecks, TrapOnlyKeepsEliminatingProvenChecks)
+{
+    const auto ir = utils::compile_ir(induction_loop, CompilerOptions { .bounds_checks = BoundsCheckMode::TrapOnly });
+
+    EXPECT_FALSE(has_check(ir));
+}
@@ -0,0 +1,34 @@
+#include <gtest/gtest.h>
+
+#include "kyoto/KType.h"
+#include "kyoto/TypeContext.h"
+
+TEST(TypeContext, InternsStructurallyEqualTypesToOneInstance)
+{
+    TypeContext types;
+    auto* char_ptr = types.pointer(types.primitive(PrimitiveType::Kind::Char));
+
+    PointerType raw(new PrimitiveType(PrimitiveType::Kind::Char));
+    EXPECT_EQ(types.intern(&raw), char_ptr);
+    EXPECT_TRUE(*char_ptr == raw);
+
+    EXPECT_EQ(types.slice(types.class_type("__main____Box")), types.slice(types.class_type("__main____Box")));
+
+    auto* i32 = types.primitive(PrimitiveType::Kind::I32);
+    EXPECT_NE(types.array(i32, 3), types.array(i32, 4));
+    EXPECT_EQ(types.function({ i32 }, KType::get_void()),
+              types.function({ i32 }, types.primitive(PrimitiveType::Kind::Void)));
+}
+
+TEST(TypeContext, InternedTypesSurviveCopyAndDelete)
+{
+    TypeContext types;
+    auto* i64 = types.primitive(PrimitiveType::Kind::I64);
+
+    KType* copy = i64->copy();
+    EXPECT_EQ(copy, i64);
+    delete copy;
+
+    EXPECT_TRUE(i64->is_interned());
+    EXPECT_EQ(types.primitive(PrimitiveType::Kind::I64)->width(), 8);
+}
@@ -0,0 +1,33 @@
+#include <gtest/gtest-param-test.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "kyoto/utils/File.h"
+#include "kyoto/utils/Test.h"
+
+DEFINE_KYOTO_TEST_SUITE(TestVectors, "../test/code/vectors.kyo");
+
+TEST(Vectors, VectorTypeNamesCannotNameVariables)
+{
+    const auto error = utils::compile_error(R"(
+fn main() i32 {
+    var i32x4 = 1;
+    return 0;
+}
+)");
+
+    EXPECT_NE(error.find("`i32x4` is a vector type and cannot be used as a name"), std::string::npos);
+}
+
+TEST(Vectors, UnsupportedLaneCountsAreNamedInTheError)
+{
+    const auto error = utils::compile_error(R"(
+fn main() i32 {
+    var v: i32x3;
+    return 0;
+}
+)");
+
+    EXPECT_NE(error.find("Vector type `i32x3` must have a power of two lanes between 2 and 64"), std::string::npos);
+}